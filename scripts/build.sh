@@ -10,6 +10,11 @@ BUILD_DIR="build"
 BROWSER_DIR="$BUILD_DIR/browser"
 NODE_DIR="$BUILD_DIR/node"
 
+# Flags for multithreaded builds: workers are pre-spawned so the persistent
+# thread pool (src/math/thread-pool.h) never waits on worker start-up
+MAX_THREADS=16
+PTHREAD_FLAGS="-pthread -s PTHREAD_POOL_SIZE=$((MAX_THREADS - 1)) -DTHREAD_POOL_MAX_THREADS=$MAX_THREADS"
+
 # Create build directories
 mkdir -p $BROWSER_DIR
 mkdir -p $NODE_DIR
@@ -26,41 +31,96 @@ if ! command -v emcc &> /dev/null; then
     exit 1
 fi
 
+# Build a module for the browser and for Node.js
+# Usage: build_module <output name> <source> <export name> <exported functions> [extra emcc flags...]
+build_module() {
+    local name=$1
+    local source=$2
+    local export_name=$3
+    local exports=$4
+    shift 4
+
+    emcc $source -o $BROWSER_DIR/$name.js \
+        -s WASM=1 \
+        -s EXPORTED_FUNCTIONS="$exports" \
+        -s EXPORTED_RUNTIME_METHODS='["ccall", "cwrap", "getValue", "setValue"]' \
+        -s ALLOW_MEMORY_GROWTH=1 \
+        -s INITIAL_MEMORY=16MB \
+        -s MAXIMUM_MEMORY=512MB \
+        -s MODULARIZE=1 \
+        -s EXPORT_NAME="$export_name" \
+        -O3 "$@"
+
+    # Create a Node.js compatible version
+    emcc $source -o $NODE_DIR/$name.js \
+        -s WASM=1 \
+        -s EXPORTED_FUNCTIONS="$exports" \
+        -s EXPORTED_RUNTIME_METHODS='["ccall", "cwrap", "getValue", "setValue"]' \
+        -s ALLOW_MEMORY_GROWTH=1 \
+        -s INITIAL_MEMORY=16MB \
+        -s MAXIMUM_MEMORY=512MB \
+        -s MODULARIZE=1 \
+        -s EXPORT_NAME="$export_name" \
+        -s ENVIRONMENT='node' \
+        -O3 "$@"
+}
+
 # Build Math Algorithms
 echo "Building Math Algorithms..."
 
+# Each math kernel is also built with -msimd128 as <name>-simd.js; the JS loader
+# (utils/wasm-loader.js) picks that variant when the runtime supports SIMD128.
+
 # Matrix Multiplication
 echo "Building Matrix Multiplication..."
-emcc $SRC_DIR/math/matrix-multiply.cpp -o $BROWSER_DIR/matrix-multiply.js \
-    -s WASM=1 \
-    -s EXPORTED_FUNCTIONS='["_create_random_matrix", "_multiply_matrices", "_free_matrix", "_run_matrix_multiplication"]' \
-    -s EXPORTED_RUNTIME_METHODS='["ccall", "cwrap", "getValue", "setValue"]' \
-    -s ALLOW_MEMORY_GROWTH=1 \
-    -s INITIAL_MEMORY=16MB \
-    -s MAXIMUM_MEMORY=512MB \
-    -s MODULARIZE=1 \
-    -s EXPORT_NAME="MatrixMultiplyWasm" \
-    -O3
-
-# Create a Node.js compatible version
-emcc $SRC_DIR/math/matrix-multiply.cpp -o $NODE_DIR/matrix-multiply.js \
-    -s WASM=1 \
-    -s EXPORTED_FUNCTIONS='["_create_random_matrix", "_multiply_matrices", "_free_matrix", "_run_matrix_multiplication"]' \
-    -s EXPORTED_RUNTIME_METHODS='["ccall", "cwrap", "getValue", "setValue"]' \
-    -s ALLOW_MEMORY_GROWTH=1 \
-    -s INITIAL_MEMORY=16MB \
-    -s MAXIMUM_MEMORY=512MB \
-    -s MODULARIZE=1 \
-    -s EXPORT_NAME="MatrixMultiplyWasm" \
-    -s ENVIRONMENT='node' \
-    -O3
-
-# Build Other Math Algorithms
-# TODO: Add build commands for gradient descent, numeric integration, and FFT
+MATRIX_EXPORTS='["_create_random_matrix", "_multiply_matrices", "_multiply_matrices_blocked", "_multiply_matrices_parallel", "_gemm_autotune", "_free_matrix", "_run_matrix_multiplication", "_run_matrix_multiplication_test", "_malloc", "_free"]'
+build_module matrix-multiply $SRC_DIR/math/matrix-multiply.cpp MatrixMultiplyWasm "$MATRIX_EXPORTS"
+build_module matrix-multiply-simd $SRC_DIR/math/matrix-multiply.cpp MatrixMultiplyWasm "$MATRIX_EXPORTS" -msimd128
+
+# Multithreaded variants (multiply_matrices_parallel uses a persistent pthread pool)
+build_module matrix-multiply-mt $SRC_DIR/math/matrix-multiply.cpp MatrixMultiplyWasm "$MATRIX_EXPORTS" $PTHREAD_FLAGS
+build_module matrix-multiply-mt-simd $SRC_DIR/math/matrix-multiply.cpp MatrixMultiplyWasm "$MATRIX_EXPORTS" $PTHREAD_FLAGS -msimd128
+
+# FFT
+echo "Building FFT..."
+FFT_EXPORTS='["_create_synthetic_signal", "_fft_plan_create", "_fft_plan_destroy", "_fft_execute", "_compute_fft", "_compute_fft_inplace", "_compute_fft_into", "_rfft_plan_create", "_rfft_plan_destroy", "_rfft_execute", "_compute_rfft", "_compute_rfft_into", "_compute_fft_batch", "_compute_fft2d", "_fft_convolve", "_stft_create", "_stft_destroy", "_stft_push", "_stft_pull", "_stft_frames_available", "_stft_frame_size", "_free_fft_data", "_run_fft", "_run_fft_test", "_malloc", "_free"]'
+build_module fft $SRC_DIR/math/fft.cpp FftWasm "$FFT_EXPORTS"
+build_module fft-simd $SRC_DIR/math/fft.cpp FftWasm "$FFT_EXPORTS" -msimd128
+
+# Numeric Integration
+echo "Building Numeric Integration..."
+INTEGRATION_EXPORTS='["_trapezoidal_integration", "_simpson_integration", "_integrand_create_polynomial", "_integrand_create_piecewise_linear", "_integrand_create_exp_sin", "_integrand_create_genz_gaussian", "_integrand_create_genz_oscillatory", "_integrand_destroy", "_integrate_trapezoidal", "_integrate_simpson", "_integrate_adaptive", "_integrate_gauss_legendre", "_integrate_romberg", "_integrate_trapezoidal_parallel", "_integrate_monte_carlo", "_get_analytical_solution", "_run_integration", "_free_integration_data", "_run_integration_test", "_malloc", "_free"]'
+build_module numeric-integration $SRC_DIR/math/numeric-integration.cpp NumericIntegrationWasm "$INTEGRATION_EXPORTS"
+build_module numeric-integration-simd $SRC_DIR/math/numeric-integration.cpp NumericIntegrationWasm "$INTEGRATION_EXPORTS" -msimd128
+
+# Multithreaded variants (integrate_trapezoidal_parallel uses the pthread pool)
+build_module numeric-integration-mt $SRC_DIR/math/numeric-integration.cpp NumericIntegrationWasm "$INTEGRATION_EXPORTS" $PTHREAD_FLAGS
+build_module numeric-integration-mt-simd $SRC_DIR/math/numeric-integration.cpp NumericIntegrationWasm "$INTEGRATION_EXPORTS" $PTHREAD_FLAGS -msimd128
+
+# Gradient Descent
+echo "Building Gradient Descent..."
+GRADIENT_EXPORTS='["_gradient_descent", "_gradient_descent_optimize", "_gradient_descent_controlled", "_gradient_descent_multistart", "_register_objective", "_unregister_objective", "_lbfgs_minimize", "_evaluate_rosenbrock", "_rosenbrock_value_gradient", "_set_rosenbrock_threads", "_run_gradient_descent", "_run_optimizer_test", "_run_lbfgs_test", "_free_gradient_descent_data", "_get_theoretical_minimum", "_get_theoretical_optimal_param", "_run_gradient_descent_test", "_malloc", "_free"]'
+# register_objective takes JS callbacks created with addFunction
+GRADIENT_FLAGS="-s ALLOW_TABLE_GROWTH=1 -s EXPORTED_RUNTIME_METHODS=[\"ccall\",\"cwrap\",\"getValue\",\"setValue\",\"addFunction\",\"removeFunction\"]"
+build_module gradient-descent $SRC_DIR/math/gradient-descent.cpp GradientDescentWasm "$GRADIENT_EXPORTS" $GRADIENT_FLAGS
+build_module gradient-descent-simd $SRC_DIR/math/gradient-descent.cpp GradientDescentWasm "$GRADIENT_EXPORTS" $GRADIENT_FLAGS -msimd128
+
+# Multithreaded variants (multi-start runs and chunked Rosenbrock kernels use the pthread pool)
+build_module gradient-descent-mt $SRC_DIR/math/gradient-descent.cpp GradientDescentWasm "$GRADIENT_EXPORTS" $GRADIENT_FLAGS $PTHREAD_FLAGS
+build_module gradient-descent-mt-simd $SRC_DIR/math/gradient-descent.cpp GradientDescentWasm "$GRADIENT_EXPORTS" $GRADIENT_FLAGS $PTHREAD_FLAGS -msimd128
 
 # Build String Processing Algorithms
 echo "Building String Processing Algorithms..."
 
-# TODO: Add build commands for JSON parser and CSV parser
+# JSON Parser (stage 1 classifies 64-byte blocks with SIMD128 when built with -msimd128)
+echo "Building JSON Parser..."
+JSON_EXPORTS='["_generate_test_json", "_parse_json_data", "_run_json_parser_test", "_json_stream_create", "_json_stream_feed", "_json_stream_finish", "_json_stream_records", "_json_stream_stats", "_json_stream_destroy", "_run_json_stream_test", "_json_document_create", "_json_document_parse", "_json_document_destroy", "_json_tape_query", "_json_tape_type", "_json_tape_get_number", "_json_tape_get_string", "_json_tape_string_length", "_json_tape_count", "_run_json_tape_test", "_json_projection_create", "_json_projection_add", "_json_projection_destroy", "_json_project", "_generate_wide_test_json", "_run_json_projection_test", "_free_json_parser_data", "_free_json_string", "_get_estimated_record_count", "_debug_parse_simple", "_malloc", "_free"]'
+build_module json-parser $SRC_DIR/string/json-parser.cpp JsonParserWasm "$JSON_EXPORTS"
+build_module json-parser-simd $SRC_DIR/string/json-parser.cpp JsonParserWasm "$JSON_EXPORTS" -msimd128
+
+# CSV Parser
+echo "Building CSV Parser..."
+CSV_EXPORTS='["_generate_test_csv", "_parse_csv_data", "_run_csv_parser_test", "_free_csv_parser_data", "_free_csv_string", "_get_estimated_csv_record_count", "_malloc", "_free"]'
+build_module csv-parser $SRC_DIR/string/csv-parser.cpp CsvParserWasm "$CSV_EXPORTS"
 
 echo "Build completed successfully!"
@@ -4,6 +4,11 @@
 #include <cmath>
 #include <complex>
 #include <stdio.h>
+#include <cstring>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
 
 extern "C" {
 
@@ -31,87 +36,1001 @@ double* create_synthetic_signal(int n) {
     return signal;
 }
 
-// Bit-reverse permutation for FFT
-void bit_reverse(double* data, int n) {
-    int j = 0;
-    for (int i = 0; i < n; i++) {
-        if (i < j) {
-            // Swap real parts
-            double temp = data[2 * i];
-            data[2 * i] = data[2 * j];
-            data[2 * j] = temp;
-            
-            // Swap imaginary parts
-            temp = data[2 * i + 1];
-            data[2 * i + 1] = data[2 * j + 1];
-            data[2 * j + 1] = temp;
+// Complex arithmetic on interleaved [real, imag] pairs
+#ifdef __wasm_simd128__
+// One complex value per f64x2: [real, imag]
+typedef v128_t cplx;
+
+static inline cplx cplx_load(const double* p) { return wasm_v128_load(p); }
+static inline void cplx_store(double* p, cplx value) { wasm_v128_store(p, value); }
+static inline cplx cplx_add(cplx a, cplx b) { return wasm_f64x2_add(a, b); }
+static inline cplx cplx_sub(cplx a, cplx b) { return wasm_f64x2_sub(a, b); }
+
+// a * b = a * b_real + swap(a) * [-b_imag, b_imag]
+static inline cplx cplx_mul(cplx a, cplx b) {
+    v128_t b_real = wasm_i64x2_shuffle(b, b, 0, 0);
+    v128_t b_imag = wasm_i64x2_shuffle(b, b, 1, 1);
+    v128_t a_swapped = wasm_i64x2_shuffle(a, a, 1, 0);
+    return wasm_f64x2_add(wasm_f64x2_mul(a, b_real),
+                          wasm_f64x2_mul(wasm_f64x2_mul(a_swapped, b_imag), wasm_f64x2_make(-1.0, 1.0)));
+}
+
+// a * (-i) = [a_imag, -a_real]
+static inline cplx cplx_mul_neg_i(cplx a) {
+    return wasm_f64x2_mul(wasm_i64x2_shuffle(a, a, 1, 0), wasm_f64x2_make(1.0, -1.0));
+}
+
+static inline cplx cplx_conj(cplx a) {
+    return wasm_f64x2_mul(a, wasm_f64x2_make(1.0, -1.0));
+}
+
+static inline cplx cplx_scale(cplx a, double factor) {
+    return wasm_f64x2_mul(a, wasm_f64x2_splat(factor));
+}
+#else
+struct cplx {
+    double re;
+    double im;
+};
+
+static inline cplx cplx_load(const double* p) { cplx c = {p[0], p[1]}; return c; }
+static inline void cplx_store(double* p, cplx value) { p[0] = value.re; p[1] = value.im; }
+static inline cplx cplx_add(cplx a, cplx b) { cplx c = {a.re + b.re, a.im + b.im}; return c; }
+static inline cplx cplx_sub(cplx a, cplx b) { cplx c = {a.re - b.re, a.im - b.im}; return c; }
+
+static inline cplx cplx_mul(cplx a, cplx b) {
+    cplx c = {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+    return c;
+}
+
+static inline cplx cplx_mul_neg_i(cplx a) { cplx c = {a.im, -a.re}; return c; }
+static inline cplx cplx_conj(cplx a) { cplx c = {a.re, -a.im}; return c; }
+static inline cplx cplx_scale(cplx a, double factor) { cplx c = {a.re * factor, a.im * factor}; return c; }
+#endif
+
+// Plan kinds, chosen by fft_plan_create from the factorization of n
+#define FFT_KIND_RADIX2 0      // n = 2^k: bit reversal + radix-4/radix-2 butterflies
+#define FFT_KIND_MIXED_RADIX 1 // n = 2^a 3^b 5^c 7^d: Stockham autosort stages
+#define FFT_KIND_BLUESTEIN 2   // any other n: chirp-z transform via a power-of-2 FFT
+
+#define FFT_MAX_FACTORS 32
+
+// Precomputed FFT plan for one transform size.
+// Twiddles are evaluated directly with cos/sin rather than by repeated complex
+// multiplication, so they carry no accumulated rounding error. Plans that need
+// scratch space own it, so executing one plan from two threads at once is not safe.
+struct FftPlan {
+    int n;
+    int kind;
+    double* twiddles;        // W_n^k = exp(-2*pi*i*k/n), interleaved [real, imag]
+                             // (k < n/2 for radix-2, k < n for mixed radix)
+    int* bit_reverse;        // radix-2: bit-reversed index of every position
+    int num_factors;         // mixed radix: radices applied stage by stage
+    int factors[FFT_MAX_FACTORS];
+    double* scratch;         // mixed radix: n complex; Bluestein: sub_plan->n complex
+    FftPlan* sub_plan;       // Bluestein: power-of-2 plan of size >= 2n - 1
+    double* chirp;           // Bluestein: exp(-i*pi*k^2/n) for k < n
+    double* chirp_spectrum;  // Bluestein: FFT of the conjugate chirp, pre-scaled by 1/m
+    double* batch_scratch;   // radix-2 batches: two signals in split layout, 4n doubles
+};
+
+// Fill table[k] = W_n^k for k < count
+static void fft_fill_twiddles(double* table, int n, int count) {
+    for (int k = 0; k < count; k++) {
+        double angle = -2.0 * M_PI * k / n;
+        table[2 * k] = cos(angle);
+        table[2 * k + 1] = sin(angle);
+    }
+}
+
+static FftPlan* fft_plan_alloc(int n, int kind) {
+    FftPlan* plan = (FftPlan*)calloc(1, sizeof(FftPlan));
+    if (!plan) return nullptr;
+    
+    plan->n = n;
+    plan->kind = kind;
+    return plan;
+}
+
+// Free an FFT plan
+EMSCRIPTEN_KEEPALIVE
+void fft_plan_destroy(FftPlan* plan) {
+    if (plan) {
+        free(plan->twiddles);
+        free(plan->bit_reverse);
+        free(plan->scratch);
+        fft_plan_destroy(plan->sub_plan);
+        free(plan->chirp);
+        free(plan->chirp_spectrum);
+        free(plan->batch_scratch);
+        free(plan);
+    }
+}
+
+// Butterfly stages over bit-reversed data, in place.
+// Pairs of radix-2 stages (half-sizes h and 2h) are fused into one radix-4 pass,
+// which needs 3 complex multiplications per 4 points instead of 4 and makes half
+// as many sweeps over the data. An odd leading stage runs as plain radix-2.
+static void fft_butterfly_stages(const FftPlan* plan, double* data) {
+    int n = plan->n;
+    const double* twiddles = plan->twiddles;
+    
+    int log2n = 0;
+    while ((1 << log2n) < n) log2n++;
+    
+    int half = 1;
+    if (log2n % 2 == 1) {
+        // First radix-2 stage: all twiddles are 1
+        for (int i = 0; i < n; i += 2) {
+            cplx u = cplx_load(data + 2 * i);
+            cplx v = cplx_load(data + 2 * i + 2);
+            cplx_store(data + 2 * i, cplx_add(u, v));
+            cplx_store(data + 2 * i + 2, cplx_sub(u, v));
+        }
+        half = 2;
+    }
+    
+    for (; half < n; half *= 4) {
+        int length = 4 * half;
+        int twiddle_stride = n / length;
+        
+        for (int i = 0; i < n; i += length) {
+            for (int j = 0; j < half; j++) {
+                double* p0 = data + 2 * (i + j);
+                double* p1 = p0 + 2 * half;
+                double* p2 = p1 + 2 * half;
+                double* p3 = p2 + 2 * half;
+                
+                cplx w1 = cplx_load(twiddles + 2 * j * twiddle_stride);     // W_{4h}^j
+                cplx w2 = cplx_load(twiddles + 4 * j * twiddle_stride);     // W_{2h}^j
+                
+                // First radix-2 stage (half-size h)
+                cplx a = cplx_load(p0);
+                cplx b = cplx_mul(cplx_load(p1), w2);
+                cplx c = cplx_load(p2);
+                cplx d = cplx_mul(cplx_load(p3), w2);
+                cplx a1 = cplx_add(a, b);
+                cplx b1 = cplx_sub(a, b);
+                cplx c1 = cplx_add(c, d);
+                cplx d1 = cplx_sub(c, d);
+                
+                // Second radix-2 stage (half-size 2h); W_{4h}^(j+h) = -i * W_{4h}^j
+                cplx c2 = cplx_mul(c1, w1);
+                cplx d2 = cplx_mul_neg_i(cplx_mul(d1, w1));
+                cplx_store(p0, cplx_add(a1, c2));
+                cplx_store(p2, cplx_sub(a1, c2));
+                cplx_store(p1, cplx_add(b1, d2));
+                cplx_store(p3, cplx_sub(b1, d2));
+            }
+        }
+    }
+}
+
+// Stockham autosort stages for n = product of plan->factors.
+// Each stage reads one buffer and writes the other, so no permutation pass is
+// needed. Returns the buffer holding the result (data or plan->scratch).
+static double* fft_mixed_radix_stages(const FftPlan* plan, double* data) {
+    int n = plan->n;
+    const double* twiddles = plan->twiddles;
+    double* x = data;
+    double* y = plan->scratch;
+    int stride = 1;
+    int length = n;
+    
+    for (int f = 0; f < plan->num_factors; f++) {
+        int p = plan->factors[f];
+        int m = length / p;
+        
+        for (int q = 0; q < m; q++) {
+            for (int t = 0; t < stride; t++) {
+                const double* in = x + 2 * (q * stride + t);
+                double* out = y + 2 * (q * p * stride + t);
+                
+                if (p == 2) {
+                    cplx a0 = cplx_load(in);
+                    cplx a1 = cplx_load(in + 2 * stride * m);
+                    cplx_store(out, cplx_add(a0, a1));
+                    cplx_store(out + 2 * stride,
+                               cplx_mul(cplx_sub(a0, a1), cplx_load(twiddles + 2 * stride * q)));
+                    continue;
+                }
+                
+                // Generic radix-p DFT: y[k] = W_length^(q*k) * sum_r a[r] * W_p^(r*k)
+                cplx a[7];
+                for (int r = 0; r < p; r++) {
+                    a[r] = cplx_load(in + 2 * r * stride * m);
+                }
+                for (int k = 0; k < p; k++) {
+                    cplx sum = a[0];
+                    for (int r = 1; r < p; r++) {
+                        int root = (n / p) * ((r * k) % p);
+                        sum = cplx_add(sum, cplx_mul(a[r], cplx_load(twiddles + 2 * root)));
+                    }
+                    if (q > 0 && k > 0) {
+                        sum = cplx_mul(sum, cplx_load(twiddles + 2 * stride * q * k));
+                    }
+                    cplx_store(out + 2 * k * stride, sum);
+                }
+            }
+        }
+        
+        double* temp = x;
+        x = y;
+        y = temp;
+        stride *= p;
+        length = m;
+    }
+    
+    return x;
+}
+
+// Run a planned FFT: output = FFT(input), both interleaved complex of plan->n values.
+// input and output may be the same buffer. Returns 0 on success, -1 on invalid arguments.
+EMSCRIPTEN_KEEPALIVE
+int fft_execute(const FftPlan* plan, const double* input, double* output) {
+    if (!plan || !input || !output) return -1;
+    
+    int n = plan->n;
+    
+    if (plan->kind == FFT_KIND_MIXED_RADIX) {
+        if (input != output) {
+            memcpy(output, input, n * 2 * sizeof(double));
+        }
+        double* result = fft_mixed_radix_stages(plan, output);
+        if (result != output) {
+            memcpy(output, result, n * 2 * sizeof(double));
+        }
+        return 0;
+    }
+    
+    if (plan->kind == FFT_KIND_BLUESTEIN) {
+        // X[k] = w[k] * IFFT(FFT(x * w) * FFT(conj(w)))[k], with w[k] = exp(-i*pi*k^2/n)
+        int m = plan->sub_plan->n;
+        double* work = plan->scratch;
+        
+        for (int k = 0; k < n; k++) {
+            cplx_store(work + 2 * k, cplx_mul(cplx_load(input + 2 * k), cplx_load(plan->chirp + 2 * k)));
         }
+        memset(work + 2 * n, 0, (m - n) * 2 * sizeof(double));
+        
+        fft_execute(plan->sub_plan, work, work);
+        
+        // Inverse FFT via conj(FFT(conj(.))); the 1/m scale is folded into chirp_spectrum
+        for (int k = 0; k < m; k++) {
+            cplx product = cplx_mul(cplx_load(work + 2 * k), cplx_load(plan->chirp_spectrum + 2 * k));
+            cplx_store(work + 2 * k, cplx_conj(product));
+        }
+        
+        fft_execute(plan->sub_plan, work, work);
         
-        int k = n / 2;
-        while (k > 0 && k <= j) {
-            j -= k;
-            k /= 2;
+        for (int k = 0; k < n; k++) {
+            cplx_store(output + 2 * k, cplx_mul(cplx_conj(cplx_load(work + 2 * k)), cplx_load(plan->chirp + 2 * k)));
+        }
+        return 0;
+    }
+    
+    const int* reverse = plan->bit_reverse;
+    
+    if (input == output) {
+        // In-place bit-reversal: swap each pair once
+        for (int i = 0; i < n; i++) {
+            int j = reverse[i];
+            if (i < j) {
+                cplx temp = cplx_load(output + 2 * i);
+                cplx_store(output + 2 * i, cplx_load(output + 2 * j));
+                cplx_store(output + 2 * j, temp);
+            }
+        }
+    } else {
+        // Copy fused with the bit-reversal permutation
+        for (int i = 0; i < n; i++) {
+            cplx_store(output + 2 * i, cplx_load(input + 2 * reverse[i]));
+        }
+    }
+    
+    fft_butterfly_stages(plan, output);
+    
+    return 0;
+}
+
+static FftPlan* fft_plan_create_radix2(int n) {
+    FftPlan* plan = fft_plan_alloc(n, FFT_KIND_RADIX2);
+    if (!plan) return nullptr;
+    
+    plan->twiddles = (double*)malloc((n / 2 + 1) * 2 * sizeof(double));
+    plan->bit_reverse = (int*)malloc(n * sizeof(int));
+    if (!plan->twiddles || !plan->bit_reverse) {
+        fft_plan_destroy(plan);
+        return nullptr;
+    }
+    
+    // Twiddle table
+    fft_fill_twiddles(plan->twiddles, n, n / 2);
+    
+    // Bit-reversal permutation table
+    int log2n = 0;
+    while ((1 << log2n) < n) log2n++;
+    for (int i = 0; i < n; i++) {
+        int reversed = 0;
+        for (int bit = 0; bit < log2n; bit++) {
+            reversed |= ((i >> bit) & 1) << (log2n - 1 - bit);
+        }
+        plan->bit_reverse[i] = reversed;
+    }
+    
+    return plan;
+}
+
+static FftPlan* fft_plan_create_mixed_radix(int n, const int* factors, int num_factors) {
+    FftPlan* plan = fft_plan_alloc(n, FFT_KIND_MIXED_RADIX);
+    if (!plan) return nullptr;
+    
+    plan->num_factors = num_factors;
+    memcpy(plan->factors, factors, num_factors * sizeof(int));
+    plan->twiddles = (double*)malloc(n * 2 * sizeof(double));
+    plan->scratch = (double*)malloc(n * 2 * sizeof(double));
+    if (!plan->twiddles || !plan->scratch) {
+        fft_plan_destroy(plan);
+        return nullptr;
+    }
+    
+    fft_fill_twiddles(plan->twiddles, n, n);
+    
+    return plan;
+}
+
+static FftPlan* fft_plan_create_bluestein(int n) {
+    int m = 1;
+    while (m < 2 * n - 1) m *= 2;
+    
+    FftPlan* plan = fft_plan_alloc(n, FFT_KIND_BLUESTEIN);
+    if (!plan) return nullptr;
+    
+    plan->sub_plan = fft_plan_create_radix2(m);
+    plan->scratch = (double*)malloc(m * 2 * sizeof(double));
+    plan->chirp = (double*)malloc(n * 2 * sizeof(double));
+    plan->chirp_spectrum = (double*)calloc(m * 2, sizeof(double));
+    if (!plan->sub_plan || !plan->scratch || !plan->chirp || !plan->chirp_spectrum) {
+        fft_plan_destroy(plan);
+        return nullptr;
+    }
+    
+    // Chirp w[k] = exp(-i*pi*k^2/n); k^2 is reduced mod 2n to keep the angle small
+    for (int k = 0; k < n; k++) {
+        long long k_squared = ((long long)k * k) % (2LL * n);
+        double angle = -M_PI * (double)k_squared / n;
+        plan->chirp[2 * k] = cos(angle);
+        plan->chirp[2 * k + 1] = sin(angle);
+    }
+    
+    // Circular filter conj(w[|k|]), transformed once and pre-scaled for the inverse FFT
+    double* filter = plan->chirp_spectrum;
+    for (int k = 0; k < n; k++) {
+        double real = plan->chirp[2 * k] / m;
+        double imag = -plan->chirp[2 * k + 1] / m;
+        filter[2 * k] = real;
+        filter[2 * k + 1] = imag;
+        if (k > 0) {
+            filter[2 * (m - k)] = real;
+            filter[2 * (m - k) + 1] = imag;
         }
-        j += k;
     }
+    fft_execute(plan->sub_plan, filter, filter);
+    
+    return plan;
+}
+
+// Create an FFT plan for any size n >= 1. Powers of 2 use the radix-4/radix-2
+// kernel, sizes made of factors 2, 3, 5 and 7 use mixed-radix stages, and sizes
+// with larger prime factors fall back to Bluestein's chirp-z algorithm.
+EMSCRIPTEN_KEEPALIVE
+FftPlan* fft_plan_create(int n) {
+    if (n <= 0) return nullptr;
+    
+    if ((n & (n - 1)) == 0) return fft_plan_create_radix2(n);
+    
+    static const int radices[] = {2, 3, 5, 7};
+    int factors[FFT_MAX_FACTORS];
+    int num_factors = 0;
+    int remaining = n;
+    for (int r = 0; r < 4; r++) {
+        while (remaining % radices[r] == 0) {
+            factors[num_factors++] = radices[r];
+            remaining /= radices[r];
+        }
+    }
+    
+    if (remaining == 1) return fft_plan_create_mixed_radix(n, factors, num_factors);
+    
+    return fft_plan_create_bluestein(n);
+}
+
+// Plans reused across compute_fft* calls; a few sizes are kept so that callers
+// alternating between sizes (e.g. the row and column passes of a 2D FFT) do not
+// rebuild them. The oldest entry is evicted first.
+#define FFT_PLAN_CACHE_SIZE 4
+static FftPlan* cached_plans[FFT_PLAN_CACHE_SIZE] = {nullptr};
+static int next_cache_slot = 0;
+
+static FftPlan* get_cached_plan(int n) {
+    for (int i = 0; i < FFT_PLAN_CACHE_SIZE; i++) {
+        if (cached_plans[i] && cached_plans[i]->n == n) return cached_plans[i];
+    }
+    
+    FftPlan* plan = fft_plan_create(n);
+    if (!plan) return nullptr;
+    
+    fft_plan_destroy(cached_plans[next_cache_slot]);
+    cached_plans[next_cache_slot] = plan;
+    next_cache_slot = (next_cache_slot + 1) % FFT_PLAN_CACHE_SIZE;
+    return plan;
 }
 
 // Fast Fourier Transform implementation
 EMSCRIPTEN_KEEPALIVE
 double* compute_fft(double* input, int n) {
-    if (!input || n <= 0 || (n & (n - 1)) != 0) return nullptr; // n must be power of 2
+    if (!input || n <= 0) return nullptr;
+    
+    FftPlan* plan = get_cached_plan(n);
+    if (!plan) return nullptr;
     
     // Allocate output array
     double* output = (double*)malloc(n * 2 * sizeof(double));
     if (!output) return nullptr;
     
-    // Copy input to output
-    for (int i = 0; i < n * 2; i++) {
-        output[i] = input[i];
+    fft_execute(plan, input, output);
+    
+    return output;
+}
+
+// In-place FFT of n interleaved complex values.
+// Allocation-free once a plan for n is cached. Returns 0 on success, -1 on failure.
+EMSCRIPTEN_KEEPALIVE
+int compute_fft_inplace(double* data, int n) {
+    if (!data || n <= 0) return -1;
+    
+    FftPlan* plan = get_cached_plan(n);
+    if (!plan) return -1;
+    
+    return fft_execute(plan, data, data);
+}
+
+// Out-of-place FFT into a caller-provided buffer of n interleaved complex values.
+// Allocation-free once a plan for n is cached. Returns 0 on success, -1 on failure.
+EMSCRIPTEN_KEEPALIVE
+int compute_fft_into(const double* input, double* output, int n) {
+    if (!input || !output || n <= 0) return -1;
+    
+    FftPlan* plan = get_cached_plan(n);
+    if (!plan) return -1;
+    
+    return fft_execute(plan, input, output);
+}
+
+// Real-input FFT plan: a size-n real transform packed into a size-n/2 complex one
+struct RfftPlan {
+    int n;
+    FftPlan* half;     // complex plan of size n/2
+    double* twiddles;  // W_n^k for k <= n/2, interleaved [real, imag]
+};
+
+// Create a real-input FFT plan for size n (even, at least 2)
+EMSCRIPTEN_KEEPALIVE
+RfftPlan* rfft_plan_create(int n) {
+    if (n < 2 || n % 2 != 0) return nullptr; // n must be even
+    
+    RfftPlan* plan = (RfftPlan*)malloc(sizeof(RfftPlan));
+    if (!plan) return nullptr;
+    
+    plan->n = n;
+    plan->half = fft_plan_create(n / 2);
+    plan->twiddles = (double*)malloc((n / 2 + 1) * 2 * sizeof(double));
+    if (!plan->half || !plan->twiddles) {
+        fft_plan_destroy(plan->half);
+        if (plan->twiddles) free(plan->twiddles);
+        free(plan);
+        return nullptr;
+    }
+    
+    for (int k = 0; k <= n / 2; k++) {
+        double angle = -2.0 * M_PI * k / n;
+        plan->twiddles[2 * k] = cos(angle);
+        plan->twiddles[2 * k + 1] = sin(angle);
+    }
+    
+    return plan;
+}
+
+// Free a real-input FFT plan
+EMSCRIPTEN_KEEPALIVE
+void rfft_plan_destroy(RfftPlan* plan) {
+    if (plan) {
+        fft_plan_destroy(plan->half);
+        free(plan->twiddles);
+        free(plan);
+    }
+}
+
+// Run a planned real-input FFT of plan->n real samples. Writes the n/2 + 1
+// non-redundant bins (interleaved complex) to output; the remaining bins are
+// their complex conjugates. Returns 0 on success, -1 on invalid arguments.
+EMSCRIPTEN_KEEPALIVE
+int rfft_execute(const RfftPlan* plan, const double* input, double* output) {
+    if (!plan || !input || !output) return -1;
+    
+    int m = plan->n / 2;
+    
+    // z[k] = x[2k] + i*x[2k+1]: the real input read as m complex values
+    fft_execute(plan->half, input, output);
+    
+    // Split Z into the spectra of the even and odd samples and recombine:
+    // X[k] = (Z[k] + conj(Z[m-k])) / 2 - i * W_n^k * (Z[k] - conj(Z[m-k])) / 2
+    double z0_real = output[0];
+    double z0_imag = output[1];
+    
+    for (int k = 1; k <= m / 2; k++) {
+        cplx zk = cplx_load(output + 2 * k);
+        cplx zmk = cplx_load(output + 2 * (m - k));
+        
+        cplx even_k = cplx_scale(cplx_add(zk, cplx_conj(zmk)), 0.5);
+        cplx odd_k = cplx_mul_neg_i(cplx_scale(cplx_sub(zk, cplx_conj(zmk)), 0.5));
+        cplx even_mk = cplx_scale(cplx_add(zmk, cplx_conj(zk)), 0.5);
+        cplx odd_mk = cplx_mul_neg_i(cplx_scale(cplx_sub(zmk, cplx_conj(zk)), 0.5));
+        
+        cplx_store(output + 2 * k,
+                   cplx_add(even_k, cplx_mul(odd_k, cplx_load(plan->twiddles + 2 * k))));
+        cplx_store(output + 2 * (m - k),
+                   cplx_add(even_mk, cplx_mul(odd_mk, cplx_load(plan->twiddles + 2 * (m - k)))));
+    }
+    
+    // DC and Nyquist bins are purely real
+    output[0] = z0_real + z0_imag;
+    output[1] = 0.0;
+    output[2 * m] = z0_real - z0_imag;
+    output[2 * m + 1] = 0.0;
+    
+    return 0;
+}
+
+// Real-input plan reused across compute_rfft calls of the same size
+static RfftPlan* cached_rfft_plan = nullptr;
+
+static RfftPlan* get_cached_rfft_plan(int n) {
+    if (cached_rfft_plan && cached_rfft_plan->n == n) return cached_rfft_plan;
+    
+    RfftPlan* plan = rfft_plan_create(n);
+    if (!plan) return nullptr;
+    
+    rfft_plan_destroy(cached_rfft_plan);
+    cached_rfft_plan = plan;
+    return plan;
+}
+
+// Real-input FFT of n real samples into a caller-provided buffer of n/2 + 1
+// complex values (n + 2 doubles). Returns 0 on success, -1 on failure.
+EMSCRIPTEN_KEEPALIVE
+int compute_rfft_into(const double* input, double* output, int n) {
+    if (!input || !output || n < 2 || n % 2 != 0) return -1; // n must be even
+    
+    RfftPlan* plan = get_cached_rfft_plan(n);
+    if (!plan) return -1;
+    
+    return rfft_execute(plan, input, output);
+}
+
+// Real-input FFT of n real samples; returns n/2 + 1 interleaved complex bins
+EMSCRIPTEN_KEEPALIVE
+double* compute_rfft(const double* input, int n) {
+    if (!input || n < 2 || n % 2 != 0) return nullptr; // n must be even
+    
+    double* output = (double*)malloc((n / 2 + 1) * 2 * sizeof(double));
+    if (!output) return nullptr;
+    
+    if (compute_rfft_into(input, output, n) != 0) {
+        free(output);
+        return nullptr;
+    }
+    
+    return output;
+}
+
+#ifdef __wasm_simd128__
+// Two complex vectors in split layout: lane 0 belongs to one signal, lane 1 to the other
+struct cplx_pair {
+    v128_t re;
+    v128_t im;
+};
+
+static inline cplx_pair pair_load(const double* re, const double* im) {
+    cplx_pair p = {wasm_v128_load(re), wasm_v128_load(im)};
+    return p;
+}
+
+static inline void pair_store(double* re, double* im, cplx_pair p) {
+    wasm_v128_store(re, p.re);
+    wasm_v128_store(im, p.im);
+}
+
+static inline cplx_pair pair_add(cplx_pair a, cplx_pair b) {
+    cplx_pair p = {wasm_f64x2_add(a.re, b.re), wasm_f64x2_add(a.im, b.im)};
+    return p;
+}
+
+static inline cplx_pair pair_sub(cplx_pair a, cplx_pair b) {
+    cplx_pair p = {wasm_f64x2_sub(a.re, b.re), wasm_f64x2_sub(a.im, b.im)};
+    return p;
+}
+
+// Multiply both lanes by the same twiddle; no lane shuffles are needed in split layout
+static inline cplx_pair pair_mul(cplx_pair a, const double* twiddle) {
+    v128_t w_real = wasm_f64x2_splat(twiddle[0]);
+    v128_t w_imag = wasm_f64x2_splat(twiddle[1]);
+    cplx_pair p = {wasm_f64x2_sub(wasm_f64x2_mul(a.re, w_real), wasm_f64x2_mul(a.im, w_imag)),
+                   wasm_f64x2_add(wasm_f64x2_mul(a.re, w_imag), wasm_f64x2_mul(a.im, w_real))};
+    return p;
+}
+
+static inline cplx_pair pair_mul_neg_i(cplx_pair a) {
+    cplx_pair p = {a.im, wasm_f64x2_neg(a.re)};
+    return p;
+}
+
+// Transform two power-of-2 signals at once: they are transposed into split layout
+// (fused with the bit-reversal), run through the same radix-4/radix-2 stages as
+// fft_butterfly_stages with both SIMD lanes busy, and transposed back in place.
+static void fft_execute_pair(const FftPlan* plan, double* a, double* b) {
+    int n = plan->n;
+    const double* twiddles = plan->twiddles;
+    double* re = plan->batch_scratch;
+    double* im = re + 2 * n;
+    
+    for (int i = 0; i < n; i++) {
+        int j = plan->bit_reverse[i];
+        v128_t value_a = wasm_v128_load(a + 2 * j);
+        v128_t value_b = wasm_v128_load(b + 2 * j);
+        wasm_v128_store(re + 2 * i, wasm_i64x2_shuffle(value_a, value_b, 0, 2));
+        wasm_v128_store(im + 2 * i, wasm_i64x2_shuffle(value_a, value_b, 1, 3));
     }
     
-    // Bit-reverse permutation
-    bit_reverse(output, n);
+    int log2n = 0;
+    while ((1 << log2n) < n) log2n++;
     
-    // FFT computation
-    for (int length = 2; length <= n; length *= 2) {
-        double angle = -2.0 * M_PI / length;
-        double wlen_real = cos(angle);
-        double wlen_imag = sin(angle);
+    int half = 1;
+    if (log2n % 2 == 1) {
+        for (int i = 0; i < n; i += 2) {
+            cplx_pair u = pair_load(re + 2 * i, im + 2 * i);
+            cplx_pair v = pair_load(re + 2 * i + 2, im + 2 * i + 2);
+            pair_store(re + 2 * i, im + 2 * i, pair_add(u, v));
+            pair_store(re + 2 * i + 2, im + 2 * i + 2, pair_sub(u, v));
+        }
+        half = 2;
+    }
+    
+    for (; half < n; half *= 4) {
+        int length = 4 * half;
+        int twiddle_stride = n / length;
         
         for (int i = 0; i < n; i += length) {
-            double w_real = 1.0;
-            double w_imag = 0.0;
-            
-            for (int j = 0; j < length / 2; j++) {
-                int u_idx = i + j;
-                int v_idx = i + j + length / 2;
-                
-                double u_real = output[2 * u_idx];
-                double u_imag = output[2 * u_idx + 1];
-                double v_real = output[2 * v_idx];
-                double v_imag = output[2 * v_idx + 1];
-                
-                // Complex multiplication: v * w
-                double temp_real = v_real * w_real - v_imag * w_imag;
-                double temp_imag = v_real * w_imag + v_imag * w_real;
+            for (int j = 0; j < half; j++) {
+                int i0 = 2 * (i + j);
+                int i1 = i0 + 2 * half;
+                int i2 = i1 + 2 * half;
+                int i3 = i2 + 2 * half;
+                const double* w1 = twiddles + 2 * j * twiddle_stride;
+                const double* w2 = twiddles + 4 * j * twiddle_stride;
                 
-                // Butterfly operation
-                output[2 * u_idx] = u_real + temp_real;
-                output[2 * u_idx + 1] = u_imag + temp_imag;
-                output[2 * v_idx] = u_real - temp_real;
-                output[2 * v_idx + 1] = u_imag - temp_imag;
+                cplx_pair a0 = pair_load(re + i0, im + i0);
+                cplx_pair b0 = pair_mul(pair_load(re + i1, im + i1), w2);
+                cplx_pair c0 = pair_load(re + i2, im + i2);
+                cplx_pair d0 = pair_mul(pair_load(re + i3, im + i3), w2);
+                cplx_pair a1 = pair_add(a0, b0);
+                cplx_pair b1 = pair_sub(a0, b0);
+                cplx_pair c1 = pair_add(c0, d0);
+                cplx_pair d1 = pair_sub(c0, d0);
                 
-                // Update twiddle factor
-                double next_w_real = w_real * wlen_real - w_imag * wlen_imag;
-                double next_w_imag = w_real * wlen_imag + w_imag * wlen_real;
-                w_real = next_w_real;
-                w_imag = next_w_imag;
+                cplx_pair c2 = pair_mul(c1, w1);
+                cplx_pair d2 = pair_mul_neg_i(pair_mul(d1, w1));
+                pair_store(re + i0, im + i0, pair_add(a1, c2));
+                pair_store(re + i2, im + i2, pair_sub(a1, c2));
+                pair_store(re + i1, im + i1, pair_add(b1, d2));
+                pair_store(re + i3, im + i3, pair_sub(b1, d2));
             }
         }
     }
     
-    return output;
+    for (int i = 0; i < n; i++) {
+        v128_t real = wasm_v128_load(re + 2 * i);
+        v128_t imag = wasm_v128_load(im + 2 * i);
+        wasm_v128_store(a + 2 * i, wasm_i64x2_shuffle(real, imag, 0, 2));
+        wasm_v128_store(b + 2 * i, wasm_i64x2_shuffle(real, imag, 1, 3));
+    }
+}
+#endif
+
+// In-place FFT of `batch` signals of n interleaved complex values each, where
+// signal s starts at data + 2 * s * stride (stride >= n, in complex values).
+// One plan serves the whole batch, so twiddles stay hot in cache; in SIMD builds
+// power-of-2 signals are transformed two at a time, one per f64x2 lane.
+// Returns 0 on success, -1 on failure.
+EMSCRIPTEN_KEEPALIVE
+int compute_fft_batch(double* data, int n, int batch, int stride) {
+    if (!data || n <= 0 || batch <= 0 || stride < n) return -1;
+    
+    FftPlan* plan = get_cached_plan(n);
+    if (!plan) return -1;
+    
+    int s = 0;
+    
+#ifdef __wasm_simd128__
+    if (plan->kind == FFT_KIND_RADIX2 && batch >= 2) {
+        if (!plan->batch_scratch) {
+            plan->batch_scratch = (double*)malloc(n * 4 * sizeof(double));
+        }
+        if (plan->batch_scratch) {
+            for (; s + 1 < batch; s += 2) {
+                fft_execute_pair(plan, data + 2 * (long long)s * stride, data + 2 * (long long)(s + 1) * stride);
+            }
+        }
+    }
+#endif
+    
+    for (; s < batch; s++) {
+        double* signal = data + 2 * (long long)s * stride;
+        fft_execute(plan, signal, signal);
+    }
+    
+    return 0;
+}
+
+// Transpose a rows x cols complex matrix into dst (cols x rows), tile by tile
+// so both the reads and the writes stay within a few cache lines
+#define FFT_TRANSPOSE_TILE 16
+static void transpose_complex(const double* src, double* dst, int rows, int cols) {
+    for (int r0 = 0; r0 < rows; r0 += FFT_TRANSPOSE_TILE) {
+        int r1 = (r0 + FFT_TRANSPOSE_TILE < rows) ? r0 + FFT_TRANSPOSE_TILE : rows;
+        for (int c0 = 0; c0 < cols; c0 += FFT_TRANSPOSE_TILE) {
+            int c1 = (c0 + FFT_TRANSPOSE_TILE < cols) ? c0 + FFT_TRANSPOSE_TILE : cols;
+            for (int r = r0; r < r1; r++) {
+                for (int c = c0; c < c1; c++) {
+                    cplx_store(dst + 2 * ((long long)c * rows + r), cplx_load(src + 2 * ((long long)r * cols + c)));
+                }
+            }
+        }
+    }
+}
+
+// In-place 2D FFT of a rows x cols row-major matrix of interleaved complex values.
+// Rows are transformed as one batch; columns are transposed into contiguous rows,
+// transformed as a batch and transposed back. Returns 0 on success, -1 on failure.
+EMSCRIPTEN_KEEPALIVE
+int compute_fft2d(double* data, int rows, int cols) {
+    if (!data || rows <= 0 || cols <= 0) return -1;
+    
+    if (compute_fft_batch(data, cols, rows, cols) != 0) return -1;
+    if (rows == 1) return 0;
+    
+    double* transposed = (double*)malloc((size_t)rows * cols * 2 * sizeof(double));
+    if (!transposed) return -1;
+    
+    transpose_complex(data, transposed, rows, cols);
+    int status = compute_fft_batch(transposed, rows, cols, rows);
+    transpose_complex(transposed, data, cols, rows);
+    
+    free(transposed);
+    return status;
+}
+
+// Linear convolution of two real signals: out[0 .. na + nb - 2] = a * b.
+// The shorter signal is the filter; its spectrum is computed once and the longer
+// signal is processed with overlap-add in FFT-sized blocks. Two blocks share each
+// complex FFT (one as the real part, one as the imaginary part), which works
+// because the filter is real. Returns 0 on success, -1 on failure.
+EMSCRIPTEN_KEEPALIVE
+int fft_convolve(const double* a, int na, const double* b, int nb, double* out) {
+    if (!a || !b || !out || na <= 0 || nb <= 0) return -1;
+    
+    if (nb > na) {
+        const double* temp = a; a = b; b = temp;
+        int temp_n = na; na = nb; nb = temp_n;
+    }
+    
+    int out_length = na + nb - 1;
+    
+    // FFT size: about 4x the filter length, but no larger than the whole output needs
+    int fft_size = 64;
+    while (fft_size < 4 * nb) fft_size *= 2;
+    int full_size = 1;
+    while (full_size < out_length) full_size *= 2;
+    if (fft_size > full_size) fft_size = full_size;
+    int block = fft_size - nb + 1;
+    
+    FftPlan* plan = get_cached_plan(fft_size);
+    double* filter = (double*)calloc(fft_size * 2, sizeof(double));
+    double* work = (double*)malloc(fft_size * 2 * sizeof(double));
+    if (!plan || !filter || !work) {
+        if (filter) free(filter);
+        if (work) free(work);
+        return -1;
+    }
+    
+    // Filter spectrum, pre-scaled by 1/N for the inverse transform
+    for (int i = 0; i < nb; i++) {
+        filter[2 * i] = b[i] / fft_size;
+    }
+    fft_execute(plan, filter, filter);
+    
+    memset(out, 0, out_length * sizeof(double));
+    
+    for (int start = 0; start < na; start += 2 * block) {
+        int second = start + block;
+        int len_first = (na - start < block) ? na - start : block;
+        int len_second = (second < na) ? ((na - second < block) ? na - second : block) : 0;
+        
+        for (int i = 0; i < fft_size; i++) {
+            work[2 * i] = (i < len_first) ? a[start + i] : 0.0;
+            work[2 * i + 1] = (i < len_second) ? a[second + i] : 0.0;
+        }
+        
+        // Inverse FFT via conj(FFT(conj(.)))
+        fft_execute(plan, work, work);
+        for (int i = 0; i < fft_size; i++) {
+            cplx product = cplx_mul(cplx_load(work + 2 * i), cplx_load(filter + 2 * i));
+            cplx_store(work + 2 * i, cplx_conj(product));
+        }
+        fft_execute(plan, work, work);
+        
+        // Overlap-add: real part belongs to the first block, -imag (conjugated) to the second
+        int span_first = len_first + nb - 1;
+        for (int i = 0; i < span_first; i++) {
+            out[start + i] += work[2 * i];
+        }
+        int span_second = (len_second > 0) ? len_second + nb - 1 : 0;
+        for (int i = 0; i < span_second; i++) {
+            out[second + i] -= work[2 * i + 1];
+        }
+    }
+    
+    free(filter);
+    free(work);
+    
+    return 0;
+}
+
+// STFT window types
+#define STFT_WINDOW_RECTANGULAR 0
+#define STFT_WINDOW_HANN 1
+#define STFT_WINDOW_HAMMING 2
+#define STFT_WINDOW_BLACKMAN 3
+
+// Streaming short-time Fourier transform.
+// Samples are pushed into a ring buffer that keeps the window overlap; each
+// pulled frame is windowed straight out of the ring and transformed with a
+// real-input FFT, so frames never cross the JS/WASM boundary as raw samples.
+struct StftState {
+    int window_size;
+    int hop;
+    double* window;        // window coefficients
+    double* ring;          // input ring buffer
+    int ring_mask;         // ring capacity - 1 (capacity is a power of 2)
+    long long write_pos;   // total samples pushed
+    long long read_pos;    // start of the next frame
+    double* frame;         // windowed frame scratch
+    RfftPlan* plan;
+};
+
+// Free an STFT pipeline
+EMSCRIPTEN_KEEPALIVE
+void stft_destroy(StftState* state) {
+    if (state) {
+        free(state->window);
+        free(state->ring);
+        free(state->frame);
+        rfft_plan_destroy(state->plan);
+        free(state);
+    }
+}
+
+// Create an STFT pipeline: window_size must be even, 1 <= hop <= window_size
+EMSCRIPTEN_KEEPALIVE
+StftState* stft_create(int window_size, int hop, int window_type) {
+    if (window_size < 2 || window_size % 2 != 0 || hop <= 0 || hop > window_size) return nullptr;
+    
+    StftState* state = (StftState*)calloc(1, sizeof(StftState));
+    if (!state) return nullptr;
+    
+    // Room for several frames of look-ahead so pushes can run ahead of pulls
+    int capacity = 1;
+    while (capacity < 4 * window_size) capacity *= 2;
+    
+    state->window_size = window_size;
+    state->hop = hop;
+    state->ring_mask = capacity - 1;
+    state->window = (double*)malloc(window_size * sizeof(double));
+    state->ring = (double*)malloc(capacity * sizeof(double));
+    state->frame = (double*)malloc(window_size * sizeof(double));
+    state->plan = rfft_plan_create(window_size);
+    if (!state->window || !state->ring || !state->frame || !state->plan) {
+        stft_destroy(state);
+        return nullptr;
+    }
+    
+    // Periodic windows, as used for overlap-add spectral analysis
+    for (int i = 0; i < window_size; i++) {
+        double phase = 2.0 * M_PI * i / window_size;
+        switch (window_type) {
+            case STFT_WINDOW_HANN: state->window[i] = 0.5 - 0.5 * cos(phase); break;
+            case STFT_WINDOW_HAMMING: state->window[i] = 0.54 - 0.46 * cos(phase); break;
+            case STFT_WINDOW_BLACKMAN: state->window[i] = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase); break;
+            default: state->window[i] = 1.0; break;
+        }
+    }
+    
+    return state;
+}
+
+// Number of doubles in one output frame: window_size/2 + 1 interleaved complex bins
+EMSCRIPTEN_KEEPALIVE
+int stft_frame_size(const StftState* state) {
+    return state ? (state->window_size / 2 + 1) * 2 : 0;
+}
+
+// Append samples to the stream. Returns how many were accepted; fewer than count
+// means the ring is full and frames must be pulled before pushing the rest.
+EMSCRIPTEN_KEEPALIVE
+int stft_push(StftState* state, const double* samples, int count) {
+    if (!state || !samples || count <= 0) return 0;
+    
+    long long free_space = (long long)(state->ring_mask + 1) - (state->write_pos - state->read_pos);
+    if (count > free_space) count = (int)free_space;
+    
+    for (int i = 0; i < count; i++) {
+        state->ring[(state->write_pos + i) & state->ring_mask] = samples[i];
+    }
+    state->write_pos += count;
+    
+    return count;
+}
+
+// Number of complete frames that can be pulled right now
+EMSCRIPTEN_KEEPALIVE
+int stft_frames_available(const StftState* state) {
+    if (!state) return 0;
+    
+    long long buffered = state->write_pos - state->read_pos;
+    if (buffered < state->window_size) return 0;
+    return (int)((buffered - state->window_size) / state->hop + 1);
+}
+
+// Window and transform up to max_frames frames into frames_out
+// (stft_frame_size doubles per frame). Returns the number of frames written.
+EMSCRIPTEN_KEEPALIVE
+int stft_pull(StftState* state, double* frames_out, int max_frames) {
+    if (!state || !frames_out || max_frames <= 0) return 0;
+    
+    int frames = stft_frames_available(state);
+    if (frames > max_frames) frames = max_frames;
+    
+    int window_size = state->window_size;
+    int frame_size = stft_frame_size(state);
+    
+    for (int f = 0; f < frames; f++) {
+        // Gather the frame from the ring (at most two contiguous runs), windowing on the way
+        int start = (int)(state->read_pos & state->ring_mask);
+        int first_run = state->ring_mask + 1 - start;
+        if (first_run > window_size) first_run = window_size;
+        
+        for (int i = 0; i < first_run; i++) {
+            state->frame[i] = state->ring[start + i] * state->window[i];
+        }
+        for (int i = first_run; i < window_size; i++) {
+            state->frame[i] = state->ring[i - first_run] * state->window[i];
+        }
+        
+        rfft_execute(state->plan, state->frame, frames_out + f * frame_size);
+        state->read_pos += state->hop;
+    }
+    
+    return frames;
 }
 
 // Free memory allocated for FFT data
@@ -125,37 +1044,36 @@ void free_fft_data(double* data) {
 // Entry point function to run the FFT algorithm
 EMSCRIPTEN_KEEPALIVE
 double* run_fft(int size) {
-    if (size <= 0 || (size & (size - 1)) != 0) return nullptr; // size must be power of 2
+    if (size <= 0) return nullptr;
     
     // Create synthetic signal
     double* signal = create_synthetic_signal(size);
     if (!signal) return nullptr;
     
-    // Compute FFT
-    double* result = compute_fft(signal, size);
-    
-    // Free input signal
-    free_fft_data(signal);
+    // Compute FFT in place; the signal buffer becomes the result
+    if (compute_fft_inplace(signal, size) != 0) {
+        free_fft_data(signal);
+        return nullptr;
+    }
     
-    // Return FFT result
-    return result;
+    return signal;
 }
 
 // Entry point function to run the FFT algorithm and return statistics
 EMSCRIPTEN_KEEPALIVE
 double* run_fft_test(int size) {
-    if (size <= 0 || (size & (size - 1)) != 0) return nullptr; // size must be power of 2
+    if (size <= 0) return nullptr;
     
     // Create synthetic signal
     double* signal = create_synthetic_signal(size);
     if (!signal) return nullptr;
     
-    // Compute FFT
-    double* fft_result = compute_fft(signal, size);
-    if (!fft_result) {
+    // Compute FFT in place
+    if (compute_fft_inplace(signal, size) != 0) {
         free_fft_data(signal);
         return nullptr;
     }
+    double* fft_result = signal;
     
     // Calculate statistics for comparison
     double max_magnitude = 0.0;
@@ -180,7 +1098,6 @@ double* run_fft_test(int size) {
     // Allocate memory for results: [max_magnitude, total_energy, avg_energy, peak_frequency]
     double* results = (double*)malloc(4 * sizeof(double));
     if (!results) {
-        free_fft_data(signal);
         free_fft_data(fft_result);
         return nullptr;
     }
@@ -191,7 +1108,6 @@ double* run_fft_test(int size) {
     results[3] = (double)peak_frequency;
     
     // Free intermediate results
-    free_fft_data(signal);
     free_fft_data(fft_result);
     
     return results;
@@ -1,7 +1,498 @@
 #include <emscripten/emscripten.h>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
+#include <cstdint>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "thread-pool.h"
+
+// Optimizers for gradient_descent_optimize
+#define OPTIMIZER_SGD 0       // x -= lr * g
+#define OPTIMIZER_MOMENTUM 1  // heavy ball: v = beta1 * v - lr * g; x += v
+#define OPTIMIZER_NESTEROV 2  // Nesterov momentum, parameters kept at the look-ahead point
+#define OPTIMIZER_ADAM 3      // bias-corrected first/second moments (beta1, beta2)
+#define OPTIMIZER_RMSPROP 4   // running mean of g^2 with decay beta2
+
+#define OPTIMIZER_EPSILON 1e-8
+
+// Per-iteration constants of an optimizer update
+struct OptimizerStep {
+    double learning_rate;
+    double beta1;
+    double beta2;
+    double step_size;    // Adam: bias-corrected learning rate
+    double bias_second;  // Adam: 1 / (1 - beta2^t)
+};
+
+// Update parameter x[i] given its gradient g. m and v are the optimizer's
+// zero-initialized state vectors (unused by SGD).
+template <int Optimizer>
+static inline void optimizer_update(double* x, double* m, double* v, int i, double g, const OptimizerStep& step) {
+    if (Optimizer == OPTIMIZER_SGD) {
+        x[i] -= step.learning_rate * g;
+    } else if (Optimizer == OPTIMIZER_MOMENTUM) {
+        m[i] = step.beta1 * m[i] - step.learning_rate * g;
+        x[i] += m[i];
+    } else if (Optimizer == OPTIMIZER_NESTEROV) {
+        // Bengio et al. form: the gradient is taken at the stored (look-ahead) point
+        double velocity = step.beta1 * m[i] - step.learning_rate * g;
+        x[i] += step.beta1 * velocity - step.learning_rate * g;
+        m[i] = velocity;
+    } else if (Optimizer == OPTIMIZER_ADAM) {
+        m[i] = step.beta1 * m[i] + (1.0 - step.beta1) * g;
+        v[i] = step.beta2 * v[i] + (1.0 - step.beta2) * g * g;
+        x[i] -= step.step_size * m[i] / (sqrt(v[i] * step.bias_second) + OPTIMIZER_EPSILON);
+    } else {
+        v[i] = step.beta2 * v[i] + (1.0 - step.beta2) * g * g;
+        x[i] -= step.learning_rate * g / (sqrt(v[i]) + OPTIMIZER_EPSILON);
+    }
+}
+
+#ifdef __wasm_simd128__
+// Two-lane version of optimizer_update for x[i], x[i+1]
+template <int Optimizer>
+static inline void optimizer_update_pair(double* x, double* m, double* v, int i, v128_t g, const OptimizerStep& step) {
+    v128_t lr = wasm_f64x2_splat(step.learning_rate);
+    v128_t xi = wasm_v128_load(x + i);
+    
+    if (Optimizer == OPTIMIZER_SGD) {
+        xi = wasm_f64x2_sub(xi, wasm_f64x2_mul(lr, g));
+    } else if (Optimizer == OPTIMIZER_MOMENTUM) {
+        v128_t mi = wasm_f64x2_sub(wasm_f64x2_mul(wasm_f64x2_splat(step.beta1), wasm_v128_load(m + i)), wasm_f64x2_mul(lr, g));
+        wasm_v128_store(m + i, mi);
+        xi = wasm_f64x2_add(xi, mi);
+    } else if (Optimizer == OPTIMIZER_NESTEROV) {
+        v128_t beta1 = wasm_f64x2_splat(step.beta1);
+        v128_t velocity = wasm_f64x2_sub(wasm_f64x2_mul(beta1, wasm_v128_load(m + i)), wasm_f64x2_mul(lr, g));
+        xi = wasm_f64x2_add(xi, wasm_f64x2_sub(wasm_f64x2_mul(beta1, velocity), wasm_f64x2_mul(lr, g)));
+        wasm_v128_store(m + i, velocity);
+    } else if (Optimizer == OPTIMIZER_ADAM) {
+        v128_t mi = wasm_f64x2_add(wasm_f64x2_mul(wasm_f64x2_splat(step.beta1), wasm_v128_load(m + i)),
+                                   wasm_f64x2_mul(wasm_f64x2_splat(1.0 - step.beta1), g));
+        v128_t vi = wasm_f64x2_add(wasm_f64x2_mul(wasm_f64x2_splat(step.beta2), wasm_v128_load(v + i)),
+                                   wasm_f64x2_mul(wasm_f64x2_mul(wasm_f64x2_splat(1.0 - step.beta2), g), g));
+        wasm_v128_store(m + i, mi);
+        wasm_v128_store(v + i, vi);
+        v128_t denominator = wasm_f64x2_add(wasm_f64x2_sqrt(wasm_f64x2_mul(vi, wasm_f64x2_splat(step.bias_second))),
+                                            wasm_f64x2_splat(OPTIMIZER_EPSILON));
+        xi = wasm_f64x2_sub(xi, wasm_f64x2_div(wasm_f64x2_mul(wasm_f64x2_splat(step.step_size), mi), denominator));
+    } else {
+        v128_t vi = wasm_f64x2_add(wasm_f64x2_mul(wasm_f64x2_splat(step.beta2), wasm_v128_load(v + i)),
+                                   wasm_f64x2_mul(wasm_f64x2_mul(wasm_f64x2_splat(1.0 - step.beta2), g), g));
+        wasm_v128_store(v + i, vi);
+        v128_t denominator = wasm_f64x2_add(wasm_f64x2_sqrt(vi), wasm_f64x2_splat(OPTIMIZER_EPSILON));
+        xi = wasm_f64x2_sub(xi, wasm_f64x2_div(wasm_f64x2_mul(lr, g), denominator));
+    }
+    
+    wasm_v128_store(x + i, xi);
+}
+
+// Gradient components i and i+1 (both interior) from the lane pairs
+// (x[i-1], x[i]), (x[i], x[i+1]) and (x[i+1], x[i+2]); adds their cost terms to *cost
+static inline v128_t rosenbrock_gradient_pair(v128_t left_x, v128_t xi, v128_t right_x, v128_t* cost) {
+    v128_t left = wasm_f64x2_sub(xi, wasm_f64x2_mul(left_x, left_x));
+    v128_t diff = wasm_f64x2_sub(right_x, wasm_f64x2_mul(xi, xi));
+    v128_t one_minus = wasm_f64x2_sub(wasm_f64x2_splat(1.0), xi);
+    *cost = wasm_f64x2_add(*cost, wasm_f64x2_add(wasm_f64x2_mul(wasm_f64x2_mul(wasm_f64x2_splat(100.0), diff), diff),
+                                                 wasm_f64x2_mul(one_minus, one_minus)));
+    v128_t own = wasm_f64x2_sub(wasm_f64x2_mul(wasm_f64x2_mul(wasm_f64x2_splat(-400.0), xi), diff),
+                                wasm_f64x2_mul(wasm_f64x2_splat(2.0), one_minus));
+    return wasm_f64x2_add(wasm_f64x2_mul(wasm_f64x2_splat(200.0), left), own);
+}
+#endif
+
+// Gradient component i in gather form from x[i-1], x[i], x[i+1] (previous/next are
+// ignored at the ends of the chain); adds the cost term of i to *cost
+static inline double rosenbrock_gradient_component(int i, int n, double previous, double xi, double next, double* cost) {
+    if (n == 1) return 0.0; // a single parameter has no terms
+    if (i == n - 1) return 200.0 * (xi - previous * previous);
+    
+    double diff = next - xi * xi;
+    double own = -400.0 * xi * diff - 2.0 * (1.0 - xi);
+    *cost += 100.0 * diff * diff + (1.0 - xi) * (1.0 - xi);
+    if (i == 0) return own;
+    return 200.0 * (xi - previous * previous) + own;
+}
+
+// Cost and squared gradient norm at the point an optimizer step started from
+struct StepStats {
+    double cost;
+    double grad_norm_sq;
+};
+
+// Below this many parameters per chunk the Rosenbrock kernels do not split work
+#define ROSENBROCK_MIN_CHUNK 16384
+
+// Threads used by the Rosenbrock kernels (set_rosenbrock_threads)
+static int rosenbrock_threads = 1;
+
+// Number of contiguous chunks the Rosenbrock kernels split n parameters into
+static int rosenbrock_chunk_count(int n) {
+    int chunks = rosenbrock_threads;
+    if (chunks > n / ROSENBROCK_MIN_CHUNK) chunks = n / ROSENBROCK_MIN_CHUNK;
+    return chunks < 1 ? 1 : chunks;
+}
+
+// Fused optimizer iteration over parameters [begin, end): computes each gradient
+// component in gather form, applies the update in place and accumulates the cost.
+// The pre-update x[i-1] is carried along, so later components still see the old
+// iterate. left_halo / right_halo are the pre-update values of x[begin-1] and x[end],
+// captured before any chunk started writing.
+template <int Optimizer>
+static StepStats rosenbrock_fused_range(double* x, double* m, double* v, int n, int begin, int end,
+                                        double left_halo, double right_halo, const OptimizerStep& step) {
+    double cost = 0.0;
+    double grad_norm_sq = 0.0;
+    double previous = left_halo;
+    
+    // First component of the range
+    double xi = x[begin];
+    double g = rosenbrock_gradient_component(begin, n, previous, xi, begin + 1 < end ? x[begin + 1] : right_halo, &cost);
+    grad_norm_sq += g * g;
+    previous = xi;
+    optimizer_update<Optimizer>(x, m, v, begin, g, step);
+    if (begin + 1 == end) {
+        StepStats stats = {cost, grad_norm_sq};
+        return stats;
+    }
+    
+    // Interior components: x[i+1] is still unmodified
+    int i = begin + 1;
+#ifdef __wasm_simd128__
+    v128_t cost_pair = wasm_f64x2_splat(0.0);
+    v128_t norm_pair = wasm_f64x2_splat(0.0);
+    for (; i + 2 < end; i += 2) {
+        v128_t x_pair = wasm_v128_load(x + i);
+        v128_t left_x = wasm_f64x2_make(previous, x[i]);
+        v128_t right_x = wasm_v128_load(x + i + 1);
+        previous = x[i + 1];
+        
+        v128_t g_pair = rosenbrock_gradient_pair(left_x, x_pair, right_x, &cost_pair);
+        norm_pair = wasm_f64x2_add(norm_pair, wasm_f64x2_mul(g_pair, g_pair));
+        optimizer_update_pair<Optimizer>(x, m, v, i, g_pair, step);
+    }
+    cost += wasm_f64x2_extract_lane(cost_pair, 0) + wasm_f64x2_extract_lane(cost_pair, 1);
+    grad_norm_sq += wasm_f64x2_extract_lane(norm_pair, 0) + wasm_f64x2_extract_lane(norm_pair, 1);
+#endif
+    for (; i < end - 1; i++) {
+        xi = x[i];
+        double diff = x[i + 1] - xi * xi;
+        g = 200.0 * (xi - previous * previous) + (-400.0 * xi * diff - 2.0 * (1.0 - xi));
+        cost += 100.0 * diff * diff + (1.0 - xi) * (1.0 - xi);
+        grad_norm_sq += g * g;
+        previous = xi;
+        optimizer_update<Optimizer>(x, m, v, i, g, step);
+    }
+    
+    // Last component of the range
+    xi = x[end - 1];
+    g = rosenbrock_gradient_component(end - 1, n, previous, xi, right_halo, &cost);
+    grad_norm_sq += g * g;
+    optimizer_update<Optimizer>(x, m, v, end - 1, g, step);
+    
+    StepStats stats = {cost, grad_norm_sq};
+    return stats;
+}
+
+// One fused Rosenbrock optimizer iteration over all parameters. Large problems are
+// split into contiguous chunks on the thread pool; the halo values at the chunk
+// boundaries are read before any chunk is updated, and the partial sums are
+// combined in chunk order.
+template <int Optimizer>
+static StepStats rosenbrock_fused_step(double* x, double* m, double* v, int n, const OptimizerStep& step) {
+    int chunks = rosenbrock_chunk_count(n);
+    if (chunks == 1) return rosenbrock_fused_range<Optimizer>(x, m, v, n, 0, n, 0.0, 0.0, step);
+    
+    double halos[2 * THREAD_POOL_MAX_THREADS];
+    StepStats partials[THREAD_POOL_MAX_THREADS];
+    for (int c = 0; c < chunks; c++) {
+        int begin = (int)((long long)n * c / chunks);
+        int end = (int)((long long)n * (c + 1) / chunks);
+        halos[2 * c] = begin > 0 ? x[begin - 1] : 0.0;
+        halos[2 * c + 1] = end < n ? x[end] : 0.0;
+    }
+    
+    parallel_for(chunks, chunks, [&](int c, int) {
+        int begin = (int)((long long)n * c / chunks);
+        int end = (int)((long long)n * (c + 1) / chunks);
+        partials[c] = rosenbrock_fused_range<Optimizer>(x, m, v, n, begin, end, halos[2 * c], halos[2 * c + 1], step);
+    });
+    
+    StepStats stats = {0.0, 0.0};
+    for (int c = 0; c < chunks; c++) {
+        stats.cost += partials[c].cost;
+        stats.grad_norm_sq += partials[c].grad_norm_sq;
+    }
+    return stats;
+}
+
+// Rosenbrock value over the terms of [begin, end) and gradient components [begin, end)
+// in one gather-form pass (x is read-only, so neighbours are read directly)
+static double rosenbrock_value_gradient_range(const double* x, double* grad, int n, int begin, int end) {
+    double cost = 0.0;
+    grad[begin] = rosenbrock_gradient_component(begin, n, begin > 0 ? x[begin - 1] : 0.0, x[begin],
+                                                begin + 1 < n ? x[begin + 1] : 0.0, &cost);
+    if (begin + 1 == end) return cost;
+    
+    int i = begin + 1;
+#ifdef __wasm_simd128__
+    v128_t cost_pair = wasm_f64x2_splat(0.0);
+    for (; i + 2 < end; i += 2) {
+        v128_t g_pair = rosenbrock_gradient_pair(wasm_v128_load(x + i - 1), wasm_v128_load(x + i),
+                                                 wasm_v128_load(x + i + 1), &cost_pair);
+        wasm_v128_store(grad + i, g_pair);
+    }
+    cost += wasm_f64x2_extract_lane(cost_pair, 0) + wasm_f64x2_extract_lane(cost_pair, 1);
+#endif
+    for (; i < end - 1; i++) {
+        double xi = x[i];
+        double diff = x[i + 1] - xi * xi;
+        grad[i] = 200.0 * (xi - x[i - 1] * x[i - 1]) + (-400.0 * xi * diff - 2.0 * (1.0 - xi));
+        cost += 100.0 * diff * diff + (1.0 - xi) * (1.0 - xi);
+    }
+    
+    grad[end - 1] = rosenbrock_gradient_component(end - 1, n, x[end - 2], x[end - 1],
+                                                  end < n ? x[end] : 0.0, &cost);
+    return cost;
+}
+
+// Why an optimizer run ended
+#define STOP_MAX_ITERATIONS 0
+#define STOP_GRAD_NORM 1
+#define STOP_COST_CHANGE 2
+#define STOP_TIME_BUDGET 3
+#define STOP_DIVERGED 4  // cost became NaN or infinite
+
+// Early stopping and telemetry settings, filled in by the caller.
+// wasm32 layout for JS: grad_tol @0, rel_cost_tol @8, time_budget_ms @16,
+// trace_stride @24, trace_capacity @28, trace @32 (40 bytes).
+struct ConvergenceControl {
+    double grad_tol;        // stop once ||grad|| <= grad_tol (0 disables)
+    double rel_cost_tol;    // stop once |cost change| <= rel_cost_tol * |previous cost| (0 disables)
+    double time_budget_ms;  // stop once this much wall-clock time has passed (0 disables)
+    int trace_stride;       // record every trace_stride-th iteration (0 disables)
+    int trace_capacity;     // number of (cost, grad_norm) pairs trace can hold
+    double* trace;          // caller-owned buffer of 2 * trace_capacity doubles
+};
+
+// Outcome of run_optimizer
+struct OptimizerRun {
+    int iterations;
+    int stop_reason;
+    int trace_entries;
+    StepStats last;  // cost and squared gradient norm at the start of the last iteration
+};
+
+// Run up to n_iterations of the given optimizer on x (with state vectors m, v).
+// The convergence checks use the cost and gradient that each fused step already
+// computes, so they cost no extra passes over x.
+template <int Optimizer>
+static OptimizerRun run_optimizer(double* x, double* m, double* v, int n, int n_iterations,
+                                  double learning_rate, double beta1, double beta2,
+                                  const ConvergenceControl* control) {
+    OptimizerStep step = {learning_rate, beta1, beta2, learning_rate, 1.0};
+    OptimizerRun run = {0, STOP_MAX_ITERATIONS, 0, {0.0, 0.0}};
+    double beta1_power = 1.0;
+    double beta2_power = 1.0;
+    double start_time = (control && control->time_budget_ms > 0.0) ? emscripten_get_now() : 0.0;
+    double previous_cost = 0.0;
+    
+    for (int iter = 0; iter < n_iterations; iter++) {
+        if (Optimizer == OPTIMIZER_ADAM) {
+            beta1_power *= beta1;
+            beta2_power *= beta2;
+            step.step_size = learning_rate / (1.0 - beta1_power);
+            step.bias_second = 1.0 / (1.0 - beta2_power);
+        }
+        run.last = rosenbrock_fused_step<Optimizer>(x, m, v, n, step);
+        run.iterations = iter + 1;
+        if (!control) continue;
+        
+        double grad_norm = sqrt(run.last.grad_norm_sq);
+        if (control->trace && control->trace_stride > 0 && iter % control->trace_stride == 0 &&
+            run.trace_entries < control->trace_capacity) {
+            control->trace[2 * run.trace_entries] = run.last.cost;
+            control->trace[2 * run.trace_entries + 1] = grad_norm;
+            run.trace_entries++;
+        }
+        
+        if (!std::isfinite(run.last.cost)) {
+            run.stop_reason = STOP_DIVERGED;
+            break;
+        }
+        if (control->grad_tol > 0.0 && grad_norm <= control->grad_tol) {
+            run.stop_reason = STOP_GRAD_NORM;
+            break;
+        }
+        if (control->rel_cost_tol > 0.0 && iter > 0 &&
+            fabs(previous_cost - run.last.cost) <= control->rel_cost_tol * fabs(previous_cost)) {
+            run.stop_reason = STOP_COST_CHANGE;
+            break;
+        }
+        if (control->time_budget_ms > 0.0 && emscripten_get_now() - start_time >= control->time_budget_ms) {
+            run.stop_reason = STOP_TIME_BUDGET;
+            break;
+        }
+        previous_cost = run.last.cost;
+    }
+    
+    return run;
+}
+
+// Instantiate run_optimizer for a runtime OPTIMIZER_* value
+static OptimizerRun dispatch_optimizer(int optimizer, double* x, double* m, double* v, int n, int n_iterations,
+                                       double learning_rate, double beta1, double beta2,
+                                       const ConvergenceControl* control) {
+    switch (optimizer) {
+        case OPTIMIZER_MOMENTUM:
+            return run_optimizer<OPTIMIZER_MOMENTUM>(x, m, v, n, n_iterations, learning_rate, beta1, beta2, control);
+        case OPTIMIZER_NESTEROV:
+            return run_optimizer<OPTIMIZER_NESTEROV>(x, m, v, n, n_iterations, learning_rate, beta1, beta2, control);
+        case OPTIMIZER_ADAM:
+            return run_optimizer<OPTIMIZER_ADAM>(x, m, v, n, n_iterations, learning_rate, beta1, beta2, control);
+        case OPTIMIZER_RMSPROP:
+            return run_optimizer<OPTIMIZER_RMSPROP>(x, m, v, n, n_iterations, learning_rate, beta1, beta2, control);
+        default:
+            return run_optimizer<OPTIMIZER_SGD>(x, m, v, n, n_iterations, learning_rate, beta1, beta2, control);
+    }
+}
+
+// Objective callback: returns f(x) and writes the gradient into grad
+typedef double (*ObjectiveFunction)(const double* x, double* grad, int n, void* user_data);
+
+// Objectives usable by lbfgs_minimize; slot 0 is the built-in Rosenbrock function
+#define MAX_OBJECTIVES 16
+#define OBJECTIVE_ROSENBROCK 0
+
+struct ObjectiveEntry {
+    ObjectiveFunction function;
+    void* user_data;
+};
+
+// L-BFGS line search parameters (strong Wolfe conditions)
+#define LBFGS_WOLFE_C1 1e-4
+#define LBFGS_WOLFE_C2 0.9
+#define LBFGS_MAX_LINE_SEARCH 40
+
+// lbfgs_minimize status codes
+#define LBFGS_CONVERGED 0
+#define LBFGS_MAX_ITERATIONS 1
+#define LBFGS_LINE_SEARCH_FAILED 2
+
+static double dot_product(const double* a, const double* b, int n) {
+    double sum0 = 0.0, sum1 = 0.0;
+    int i = 0;
+    for (; i + 1 < n; i += 2) {
+        sum0 += a[i] * b[i];
+        sum1 += a[i + 1] * b[i + 1];
+    }
+    if (i < n) sum0 += a[i] * b[i];
+    return sum0 + sum1;
+}
+
+// One line search trial: step length, objective value and directional derivative
+struct LineSearchPoint {
+    double alpha;
+    double value;
+    double slope;
+};
+
+// Evaluate the objective at x + alpha * d into (x_trial, g_trial)
+static LineSearchPoint line_search_evaluate(const ObjectiveEntry& objective, const double* x, const double* d,
+                                            double alpha, double* x_trial, double* g_trial, int n, int* evaluations) {
+    for (int i = 0; i < n; i++) {
+        x_trial[i] = x[i] + alpha * d[i];
+    }
+    LineSearchPoint point;
+    point.alpha = alpha;
+    point.value = objective.function(x_trial, g_trial, n, objective.user_data);
+    point.slope = dot_product(g_trial, d, n);
+    (*evaluations)++;
+    return point;
+}
+
+// Minimizer of the cubic interpolating two trial points, safeguarded to the
+// interior of the bracket (bisection when the cubic is unusable)
+static double cubic_step(const LineSearchPoint& lo, const LineSearchPoint& hi) {
+    double low = lo.alpha < hi.alpha ? lo.alpha : hi.alpha;
+    double high = lo.alpha < hi.alpha ? hi.alpha : lo.alpha;
+    double width = high - low;
+    double midpoint = 0.5 * (low + high);
+    
+    double d1 = lo.slope + hi.slope - 3.0 * (lo.value - hi.value) / (lo.alpha - hi.alpha);
+    double radicand = d1 * d1 - lo.slope * hi.slope;
+    if (radicand < 0.0) return midpoint;
+    
+    double d2 = sqrt(radicand) * (hi.alpha > lo.alpha ? 1.0 : -1.0);
+    double denominator = hi.slope - lo.slope + 2.0 * d2;
+    if (denominator == 0.0) return midpoint;
+    
+    double alpha = hi.alpha - (hi.alpha - lo.alpha) * (hi.slope + d2 - d1) / denominator;
+    if (!(alpha > low + 0.1 * width && alpha < high - 0.1 * width)) return midpoint;
+    return alpha;
+}
+
+// Strong-Wolfe line search along d (Nocedal & Wright, algorithms 3.5 and 3.6).
+// On success (x_trial, g_trial) hold the accepted point and its value is returned
+// in *accepted.
+static bool wolfe_line_search(const ObjectiveEntry& objective, const double* x, double f0, double slope0,
+                              const double* d, double alpha, double* x_trial, double* g_trial, int n,
+                              int* evaluations, LineSearchPoint* accepted) {
+    LineSearchPoint start = {0.0, f0, slope0};
+    LineSearchPoint previous = start;
+    LineSearchPoint lo, hi;
+    bool bracketed = false;
+    
+    for (int i = 0; i < LBFGS_MAX_LINE_SEARCH; i++) {
+        LineSearchPoint current = line_search_evaluate(objective, x, d, alpha, x_trial, g_trial, n, evaluations);
+        
+        if (current.value > f0 + LBFGS_WOLFE_C1 * alpha * slope0 || (i > 0 && current.value >= previous.value)) {
+            lo = previous;
+            hi = current;
+            bracketed = true;
+            break;
+        }
+        if (fabs(current.slope) <= -LBFGS_WOLFE_C2 * slope0) {
+            *accepted = current;
+            return true;
+        }
+        if (current.slope >= 0.0) {
+            lo = current;
+            hi = previous;
+            bracketed = true;
+            break;
+        }
+        
+        previous = current;
+        alpha *= 2.0;
+    }
+    if (!bracketed) return false;
+    
+    // Zoom: shrink [lo, hi] until a point satisfies both conditions
+    for (int i = 0; i < LBFGS_MAX_LINE_SEARCH; i++) {
+        alpha = cubic_step(lo, hi);
+        LineSearchPoint current = line_search_evaluate(objective, x, d, alpha, x_trial, g_trial, n, evaluations);
+        
+        if (current.value > f0 + LBFGS_WOLFE_C1 * alpha * slope0 || current.value >= lo.value) {
+            hi = current;
+        } else {
+            if (fabs(current.slope) <= -LBFGS_WOLFE_C2 * slope0) {
+                *accepted = current;
+                return true;
+            }
+            if (current.slope * (hi.alpha - lo.alpha) >= 0.0) hi = lo;
+            lo = current;
+        }
+        if (fabs(hi.alpha - lo.alpha) <= 1e-16 * fabs(lo.alpha)) break;
+    }
+    
+    return false;
+}
 
 extern "C" {
 
@@ -9,7 +500,19 @@ extern "C" {
 // Global minimum at x[i] = 1 for all i, with f(x) = 0
 double rosenbrock_function(const double* x, int n) {
     double sum = 0.0;
-    for (int i = 0; i < n - 1; i++) {
+    int i = 0;
+#ifdef __wasm_simd128__
+    v128_t sum_pair = wasm_f64x2_splat(0.0);
+    for (; i + 2 < n; i += 2) {
+        v128_t xi = wasm_v128_load(x + i);
+        v128_t term1 = wasm_f64x2_sub(wasm_v128_load(x + i + 1), wasm_f64x2_mul(xi, xi));
+        v128_t term2 = wasm_f64x2_sub(wasm_f64x2_splat(1.0), xi);
+        sum_pair = wasm_f64x2_add(sum_pair, wasm_f64x2_add(wasm_f64x2_mul(wasm_f64x2_mul(wasm_f64x2_splat(100.0), term1), term1),
+                                                           wasm_f64x2_mul(term2, term2)));
+    }
+    sum = wasm_f64x2_extract_lane(sum_pair, 0) + wasm_f64x2_extract_lane(sum_pair, 1);
+#endif
+    for (; i < n - 1; i++) {
         double term1 = x[i + 1] - x[i] * x[i];
         double term2 = 1.0 - x[i];
         sum += 100.0 * term1 * term1 + term2 * term2;
@@ -17,23 +520,74 @@ double rosenbrock_function(const double* x, int n) {
     return sum;
 }
 
-// Gradient of Rosenbrock function
+// Gradient of Rosenbrock function, in gather form: each component reads its
+// neighbours instead of scattering into grad[i + 1], so the loop vectorizes
 void rosenbrock_gradient(const double* x, double* grad, int n) {
-    // Initialize gradient to zero
-    for (int i = 0; i < n; i++) {
-        grad[i] = 0.0;
+    rosenbrock_value_gradient_range(x, grad, n, 0, n);
+}
+
+// Rosenbrock value and gradient in one fused pass, split into contiguous chunks
+// on the thread pool for large n (see set_rosenbrock_threads)
+EMSCRIPTEN_KEEPALIVE
+double rosenbrock_value_gradient(const double* x, double* grad, int n) {
+    if (!x || !grad || n <= 0) return 0.0;
+    
+    int chunks = rosenbrock_chunk_count(n);
+    if (chunks == 1) return rosenbrock_value_gradient_range(x, grad, n, 0, n);
+    
+    double partials[THREAD_POOL_MAX_THREADS];
+    parallel_for(chunks, chunks, [&](int c, int) {
+        int begin = (int)((long long)n * c / chunks);
+        int end = (int)((long long)n * (c + 1) / chunks);
+        partials[c] = rosenbrock_value_gradient_range(x, grad, n, begin, end);
+    });
+    
+    double cost = 0.0;
+    for (int c = 0; c < chunks; c++) {
+        cost += partials[c];
     }
+    return cost;
+}
+
+// Set the number of threads the Rosenbrock kernels use for large n (<= 0 uses
+// every pool thread). Results are reproducible for a fixed setting.
+EMSCRIPTEN_KEEPALIVE
+void set_rosenbrock_threads(int threads) {
+    ThreadPool& pool = ThreadPool::instance();
+    if (threads <= 0 || threads > pool.max_threads()) threads = pool.max_threads();
+    rosenbrock_threads = threads;
+}
+
+// Built-in objective: Rosenbrock value and gradient
+static double rosenbrock_objective(const double* x, double* grad, int n, void*) {
+    return rosenbrock_value_gradient(x, grad, n);
+}
+
+static ObjectiveEntry objective_registry[MAX_OBJECTIVES] = {{rosenbrock_objective, nullptr}};
+
+// Register an objective and return its id for lbfgs_minimize, or -1 when the
+// registry is full. From JS, pass a function pointer created with addFunction
+// (signature 'diiii'), which requires -s ALLOW_TABLE_GROWTH.
+EMSCRIPTEN_KEEPALIVE
+int register_objective(ObjectiveFunction function, void* user_data) {
+    if (!function) return -1;
     
-    // Compute gradient components
-    for (int i = 0; i < n - 1; i++) {
-        double xi = x[i];
-        double xi_plus_1 = x[i + 1];
-        
-        // Gradient w.r.t. x[i]
-        grad[i] += -400.0 * xi * (xi_plus_1 - xi * xi) - 2.0 * (1.0 - xi);
-        
-        // Gradient w.r.t. x[i+1]
-        grad[i + 1] += 200.0 * (xi_plus_1 - xi * xi);
+    for (int id = 1; id < MAX_OBJECTIVES; id++) {
+        if (!objective_registry[id].function) {
+            objective_registry[id].function = function;
+            objective_registry[id].user_data = user_data;
+            return id;
+        }
+    }
+    return -1;
+}
+
+// Remove a registered objective; the built-in Rosenbrock objective cannot be removed
+EMSCRIPTEN_KEEPALIVE
+void unregister_objective(int id) {
+    if (id > OBJECTIVE_ROSENBROCK && id < MAX_OBJECTIVES) {
+        objective_registry[id].function = nullptr;
+        objective_registry[id].user_data = nullptr;
     }
 }
 
@@ -53,34 +607,325 @@ EMSCRIPTEN_KEEPALIVE
 double* gradient_descent(int n_params, int n_iterations, double learning_rate) {
     if (n_params <= 1 || n_iterations <= 0) return nullptr;
     
-    // Allocate memory for parameters and gradient
+    // Allocate memory for parameters
     double* x = (double*)malloc(n_params * sizeof(double));
-    double* grad = (double*)malloc(n_params * sizeof(double));
-    if (!x || !grad) {
-        if (x) free(x);
-        if (grad) free(grad);
-        return nullptr;
-    }
+    if (!x) return nullptr;
     
     // Initialize parameters
     initialize_parameters(x, n_params);
     
-    // Gradient descent iterations
-    for (int iter = 0; iter < n_iterations; iter++) {
-        // Compute gradient
-        rosenbrock_gradient(x, grad, n_params);
+    // Gradient descent iterations: x = x - learning_rate * gradient, one fused pass each
+    run_optimizer<OPTIMIZER_SGD>(x, nullptr, nullptr, n_params, n_iterations, learning_rate, 0.0, 0.0, nullptr);
+    
+    // Return optimized parameters
+    return x;
+}
+
+// Optimize the Rosenbrock function with the selected OPTIMIZER_*.
+// beta1 is the momentum (momentum, Nesterov) or first-moment decay (Adam); beta2 is
+// the second-moment decay (Adam, RMSProp). Parameters and optimizer state share one
+// allocation laid out as [x | m | v]; the returned pointer is x (n_params values)
+// and is freed with free_gradient_descent_data.
+EMSCRIPTEN_KEEPALIVE
+double* gradient_descent_optimize(int n_params, int n_iterations, int optimizer,
+                                  double learning_rate, double beta1, double beta2) {
+    if (n_params <= 1 || n_iterations <= 0) return nullptr;
+    if (optimizer < OPTIMIZER_SGD || optimizer > OPTIMIZER_RMSPROP) return nullptr;
+    
+    double* buffer = (double*)calloc(3 * (size_t)n_params, sizeof(double));
+    if (!buffer) return nullptr;
+    
+    double* x = buffer;
+    double* m = buffer + n_params;
+    double* v = buffer + 2 * n_params;
+    initialize_parameters(x, n_params);
+    
+    dispatch_optimizer(optimizer, x, m, v, n_params, n_iterations, learning_rate, beta1, beta2, nullptr);
+    
+    return x;
+}
+
+// Optimize the Rosenbrock function in place from x with early stopping.
+// Runs at most max_iterations of the selected OPTIMIZER_* and stops early as
+// configured by control (nullptr runs the full budget). The gradient-norm and
+// cost-change tests use values measured at the start of each iteration; the
+// optional trace receives (cost, grad_norm) pairs without any allocation.
+// Returns [final_cost, grad_norm, iterations, stop_reason, trace_entries];
+// free with free_gradient_descent_data.
+EMSCRIPTEN_KEEPALIVE
+double* gradient_descent_controlled(double* x, int n_params, int max_iterations, int optimizer,
+                                   double learning_rate, double beta1, double beta2,
+                                   const ConvergenceControl* control) {
+    if (!x || n_params <= 1 || max_iterations <= 0) return nullptr;
+    if (optimizer < OPTIMIZER_SGD || optimizer > OPTIMIZER_RMSPROP) return nullptr;
+    
+    double* state = (double*)calloc(2 * (size_t)n_params, sizeof(double));
+    double* results = (double*)malloc(5 * sizeof(double));
+    if (!state || !results) {
+        free(state);
+        free(results);
+        return nullptr;
+    }
+    
+    OptimizerRun run = dispatch_optimizer(optimizer, x, state, state + n_params, n_params, max_iterations,
+                                          learning_rate, beta1, beta2, control);
+    free(state);
+    
+    results[0] = rosenbrock_function(x, n_params);
+    results[1] = sqrt(run.last.grad_norm_sq);
+    results[2] = run.iterations;
+    results[3] = run.stop_reason;
+    results[4] = run.trace_entries;
+    
+    return results;
+}
+
+// Seeded uniform stream for multi-start initial points (splitmix64)
+static inline double multistart_uniform(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (double)(z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Run n_starts independent gradient descent runs on the Rosenbrock function on up to
+// `threads` pool threads (<= 0 uses all). Start s draws its initial point in [-1, 1]
+// from its own stream seeded with 12345 + s, so the results do not depend on the
+// thread count. Each run uses the same step size as run_gradient_descent.
+// Returns [best_cost, best_start, per-start (final_cost, grad_norm, avg_param) x n_starts,
+// best parameters x n_params]; free with free_gradient_descent_data.
+EMSCRIPTEN_KEEPALIVE
+double* gradient_descent_multistart(int n_params, int n_starts, int iters, int threads) {
+    if (n_params <= 1 || n_starts <= 0 || iters <= 0) return nullptr;
+    
+    ThreadPool& pool = ThreadPool::instance();
+    if (threads <= 0 || threads > pool.max_threads()) threads = pool.max_threads();
+    if (threads > n_starts) threads = n_starts;
+    
+    double* results = (double*)malloc((2 + 3 * (size_t)n_starts + n_params) * sizeof(double));
+    // Per worker: the current run's parameters and the worker's best parameters
+    double* scratch = (double*)malloc(2 * (size_t)threads * n_params * sizeof(double));
+    std::vector<int> best_start(threads, -1);
+    if (!results || !scratch) {
+        free(results);
+        free(scratch);
+        return nullptr;
+    }
+    
+    double learning_rate = 0.001 / sqrt(n_params);
+    double* per_start = results + 2;
+    
+    parallel_for(n_starts, threads, [&](int start, int worker) {
+        double* x = scratch + 2 * (size_t)worker * n_params;
+        double* best_x = x + n_params;
+        
+        uint64_t stream = 12345 + (uint64_t)start;
+        for (int i = 0; i < n_params; i++) {
+            x[i] = (multistart_uniform(&stream) - 0.5) * 2.0;
+        }
         
-        // Update parameters: x = x - learning_rate * gradient
+        OptimizerRun run = run_optimizer<OPTIMIZER_SGD>(x, nullptr, nullptr, n_params, iters,
+                                                        learning_rate, 0.0, 0.0, nullptr);
+        double cost = rosenbrock_function(x, n_params);
+        double avg_param = 0.0;
         for (int i = 0; i < n_params; i++) {
-            x[i] -= learning_rate * grad[i];
+            avg_param += x[i];
+        }
+        
+        per_start[3 * start] = cost;
+        per_start[3 * start + 1] = sqrt(run.last.grad_norm_sq);
+        per_start[3 * start + 2] = avg_param / n_params;
+        
+        // Keep this worker's best run; ties go to the lower start index
+        int current_best = best_start[worker];
+        if (current_best < 0 || cost < per_start[3 * current_best] ||
+            (cost == per_start[3 * current_best] && start < current_best)) {
+            best_start[worker] = start;
+            memcpy(best_x, x, n_params * sizeof(double));
+        }
+    });
+    
+    // Pick the overall best across workers with the same ordering
+    int best_worker = -1;
+    for (int w = 0; w < threads; w++) {
+        int start = best_start[w];
+        if (start < 0) continue;
+        if (best_worker < 0) {
+            best_worker = w;
+            continue;
+        }
+        int best = best_start[best_worker];
+        if (per_start[3 * start] < per_start[3 * best] ||
+            (per_start[3 * start] == per_start[3 * best] && start < best)) {
+            best_worker = w;
         }
     }
     
-    // Free gradient memory
-    free(grad);
+    results[0] = per_start[3 * best_start[best_worker]];
+    results[1] = best_start[best_worker];
+    memcpy(per_start + 3 * (size_t)n_starts, scratch + (2 * (size_t)best_worker + 1) * n_params,
+           n_params * sizeof(double));
     
-    // Return optimized parameters
-    return x;
+    free(scratch);
+    
+    return results;
+}
+
+// Minimize a registered objective with L-BFGS, starting from and updating x in place.
+// The last `history` (s, y) pairs are kept in a ring buffer; every step satisfies
+// the strong Wolfe conditions. Stops when ||grad|| <= grad_tol.
+// Returns [final_value, grad_norm, iterations, evaluations, status] where status is
+// LBFGS_CONVERGED, LBFGS_MAX_ITERATIONS or LBFGS_LINE_SEARCH_FAILED;
+// free with free_gradient_descent_data.
+EMSCRIPTEN_KEEPALIVE
+double* lbfgs_minimize(int objective_id, double* x, int n, int history, int max_iterations, double grad_tol) {
+    if (objective_id < 0 || objective_id >= MAX_OBJECTIVES || !objective_registry[objective_id].function) return nullptr;
+    if (!x || n <= 0 || history <= 0 || max_iterations < 0) return nullptr;
+    
+    const ObjectiveEntry& objective = objective_registry[objective_id];
+    
+    // Work vectors and the history ring buffer share one allocation:
+    // g, d, x_trial, g_trial, then s[history][n], y[history][n], rho[history], alpha[history]
+    size_t vector_bytes = (size_t)n * sizeof(double);
+    double* work = (double*)malloc((4 + 2 * (size_t)history) * vector_bytes + 2 * history * sizeof(double));
+    double* results = (double*)malloc(5 * sizeof(double));
+    if (!work || !results) {
+        free(work);
+        free(results);
+        return nullptr;
+    }
+    
+    double* g = work;
+    double* d = g + n;
+    double* x_trial = d + n;
+    double* g_trial = x_trial + n;
+    double* s_history = g_trial + n;
+    double* y_history = s_history + (size_t)history * n;
+    double* rho = y_history + (size_t)history * n;
+    double* alpha = rho + history;
+    
+    int evaluations = 1;
+    double f = objective.function(x, g, n, objective.user_data);
+    double grad_norm = sqrt(dot_product(g, g, n));
+    int stored = 0;  // pairs in the ring buffer
+    int newest = -1; // slot of the most recent pair
+    int iterations = 0;
+    int status = LBFGS_MAX_ITERATIONS;
+    
+    while (true) {
+        if (grad_norm <= grad_tol) {
+            status = LBFGS_CONVERGED;
+            break;
+        }
+        if (iterations >= max_iterations) break;
+        
+        // Two-loop recursion: d = -H * g
+        for (int i = 0; i < n; i++) d[i] = -g[i];
+        for (int k = 0; k < stored; k++) {
+            int slot = (newest - k + history) % history;
+            alpha[slot] = rho[slot] * dot_product(s_history + (size_t)slot * n, d, n);
+            const double* y = y_history + (size_t)slot * n;
+            for (int i = 0; i < n; i++) d[i] -= alpha[slot] * y[i];
+        }
+        if (stored > 0) {
+            const double* y = y_history + (size_t)newest * n;
+            double gamma = 1.0 / (rho[newest] * dot_product(y, y, n));
+            for (int i = 0; i < n; i++) d[i] *= gamma;
+        }
+        for (int k = stored - 1; k >= 0; k--) {
+            int slot = (newest - k + history) % history;
+            const double* s = s_history + (size_t)slot * n;
+            double beta = rho[slot] * dot_product(y_history + (size_t)slot * n, d, n);
+            for (int i = 0; i < n; i++) d[i] += (alpha[slot] - beta) * s[i];
+        }
+        
+        double slope = dot_product(g, d, n);
+        if (slope >= 0.0) {
+            // Not a descent direction: restart from steepest descent
+            stored = 0;
+            for (int i = 0; i < n; i++) d[i] = -g[i];
+            slope = -grad_norm * grad_norm;
+        }
+        
+        // Unit step once curvature information exists; scaled first step otherwise
+        double initial_step = stored > 0 ? 1.0 : 1.0 / grad_norm;
+        LineSearchPoint accepted;
+        if (!wolfe_line_search(objective, x, f, slope, d, initial_step, x_trial, g_trial, n, &evaluations, &accepted)) {
+            status = LBFGS_LINE_SEARCH_FAILED;
+            break;
+        }
+        
+        // Check the curvature of s = x_new - x and y = g_new - g before storing the
+        // pair: when the ring is full, the next slot still holds the oldest live pair
+        double curvature = 0.0;
+        double y_norm_sq = 0.0;
+        for (int i = 0; i < n; i++) {
+            double yi = g_trial[i] - g[i];
+            curvature += (x_trial[i] - x[i]) * yi;
+            y_norm_sq += yi * yi;
+        }
+        if (curvature > 1e-12 * y_norm_sq) {
+            int slot = (newest + 1) % history;
+            double* s = s_history + (size_t)slot * n;
+            double* y = y_history + (size_t)slot * n;
+            for (int i = 0; i < n; i++) {
+                s[i] = x_trial[i] - x[i];
+                y[i] = g_trial[i] - g[i];
+            }
+            rho[slot] = 1.0 / curvature;
+            newest = slot;
+            if (stored < history) stored++;
+        }
+        
+        memcpy(x, x_trial, vector_bytes);
+        memcpy(g, g_trial, vector_bytes);
+        f = accepted.value;
+        grad_norm = sqrt(dot_product(g, g, n));
+        iterations++;
+    }
+    
+    results[0] = f;
+    results[1] = grad_norm;
+    results[2] = iterations;
+    results[3] = evaluations;
+    results[4] = status;
+    
+    free(work);
+    
+    return results;
+}
+
+// Run L-BFGS (history 10) on the Rosenbrock benchmark from the standard starting point.
+// Returns [final_cost, convergence_rate, avg_param, first_param] like run_gradient_descent_test.
+EMSCRIPTEN_KEEPALIVE
+double* run_lbfgs_test(int n_iterations, int n_params) {
+    if (n_params <= 1 || n_iterations <= 0) return nullptr;
+    
+    double* x = (double*)malloc(n_params * sizeof(double));
+    if (!x) return nullptr;
+    initialize_parameters(x, n_params);
+    
+    double* stats = lbfgs_minimize(OBJECTIVE_ROSENBROCK, x, n_params, 10, n_iterations, 1e-8);
+    if (!stats) {
+        free(x);
+        return nullptr;
+    }
+    
+    double avg_param = 0.0;
+    for (int i = 0; i < n_params; i++) {
+        avg_param += x[i];
+    }
+    avg_param /= n_params;
+    
+    double final_cost = stats[0];
+    stats[1] = 1.0 / (1.0 + final_cost);
+    stats[2] = avg_param;
+    stats[3] = x[0];
+    
+    free(x);
+    
+    return stats;
 }
 
 // Evaluate Rosenbrock function at given point
@@ -200,4 +1045,58 @@ double* run_gradient_descent_test(int n_iterations, int n_params) {
     return results;
 }
 
+// Run the Rosenbrock benchmark with one of the OPTIMIZER_* methods and default
+// hyperparameters. Returns [final_cost, convergence_rate, avg_param, first_param]
+// like run_gradient_descent_test.
+EMSCRIPTEN_KEEPALIVE
+double* run_optimizer_test(int n_iterations, int n_params, int optimizer) {
+    if (n_params <= 1 || n_iterations <= 0) return nullptr;
+    
+    double learning_rate;
+    double beta1 = 0.9;
+    double beta2 = 0.999;
+    switch (optimizer) {
+        case OPTIMIZER_MOMENTUM:
+        case OPTIMIZER_NESTEROV:
+            learning_rate = 0.0002;
+            break;
+        case OPTIMIZER_ADAM:
+            learning_rate = 0.01;
+            break;
+        case OPTIMIZER_RMSPROP:
+            learning_rate = 0.001;
+            beta2 = 0.9;
+            break;
+        default:
+            learning_rate = 0.001 / sqrt(n_params);
+            break;
+    }
+    
+    double* optimized_params = gradient_descent_optimize(n_params, n_iterations, optimizer, learning_rate, beta1, beta2);
+    if (!optimized_params) return nullptr;
+    
+    double final_cost = rosenbrock_function(optimized_params, n_params);
+    
+    double avg_param = 0.0;
+    for (int i = 0; i < n_params; i++) {
+        avg_param += optimized_params[i];
+    }
+    avg_param /= n_params;
+    
+    double* results = (double*)malloc(4 * sizeof(double));
+    if (!results) {
+        free(optimized_params);
+        return nullptr;
+    }
+    
+    results[0] = final_cost;
+    results[1] = 1.0 / (1.0 + final_cost);
+    results[2] = avg_param;
+    results[3] = optimized_params[0];
+    
+    free(optimized_params);
+    
+    return results;
+}
+
 } // extern "C"
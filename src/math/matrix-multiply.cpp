@@ -3,6 +3,12 @@
 #include <cstdlib>
 #include <ctime>
 
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "thread-pool.h"
+
 extern "C" {
 
 // Create a matrix of size n×n filled with random values
@@ -20,6 +26,282 @@ double* create_random_matrix(int n) {
     return matrix;
 }
 
+// Blocking parameters for the cache-blocked GEMM kernel.
+// mc x kc block of A is packed to stay resident in L2, a kc x nc panel of B
+// is packed to stay resident in L3, and the register tile is GEMM_MR x GEMM_NR.
+struct GemmBlockParams {
+    int mc;
+    int kc;
+    int nc;
+};
+
+// Register tile of the micro-kernel (rows of A x columns of B)
+#define GEMM_MR 4
+#define GEMM_NR 4
+
+// Blocking used when the caller passes no parameters; replaced by gemm_autotune()
+static GemmBlockParams gemm_tuned_params = {0, 0, 0};
+
+static int round_up(int value, int multiple) {
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+// Clamp blocking parameters to the problem size and the register tile
+static GemmBlockParams gemm_normalize_params(GemmBlockParams params, int n) {
+    if (params.mc <= 0) params.mc = 96;
+    if (params.kc <= 0) params.kc = 256;
+    if (params.nc <= 0) params.nc = 2048;
+    
+    params.mc = round_up(params.mc < n ? params.mc : n, GEMM_MR);
+    params.nc = round_up(params.nc < n ? params.nc : n, GEMM_NR);
+    if (params.kc > n) params.kc = n;
+    
+    return params;
+}
+
+// Default blocking: sized from typical L1/L2/L3 capacities unless gemm_autotune() has run
+static GemmBlockParams gemm_default_params(int n) {
+    return gemm_normalize_params(gemm_tuned_params, n);
+}
+
+// Pack an mc x kc block of A into GEMM_MR-row slivers, zero-padding the last sliver
+static void gemm_pack_a(const double* A, int n, int row, int col, int mc, int kc, double* packed) {
+    for (int ir = 0; ir < mc; ir += GEMM_MR) {
+        int rows = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < rows; i++) {
+                packed[i] = A[(row + ir + i) * n + col + p];
+            }
+            for (int i = rows; i < GEMM_MR; i++) {
+                packed[i] = 0.0;
+            }
+            packed += GEMM_MR;
+        }
+    }
+}
+
+// Pack a kc x nc panel of B into GEMM_NR-column slivers, zero-padding the last sliver
+static void gemm_pack_b(const double* B, int n, int row, int col, int kc, int nc, double* packed) {
+    for (int jr = 0; jr < nc; jr += GEMM_NR) {
+        int cols = (nc - jr < GEMM_NR) ? nc - jr : GEMM_NR;
+        for (int p = 0; p < kc; p++) {
+            const double* b_row = B + (row + p) * n + col + jr;
+            for (int j = 0; j < cols; j++) {
+                packed[j] = b_row[j];
+            }
+            for (int j = cols; j < GEMM_NR; j++) {
+                packed[j] = 0.0;
+            }
+            packed += GEMM_NR;
+        }
+    }
+}
+
+// Micro-kernel: C[rows x cols] += packed A sliver * packed B sliver over kc
+static void gemm_micro_kernel(int kc, const double* a, const double* b,
+                              double* C, int ldc, int rows, int cols) {
+    double acc[GEMM_MR][GEMM_NR] = {{0.0}};
+    
+#ifdef __wasm_simd128__
+    // Each row of the register tile is two f64x2 accumulators
+    v128_t c00 = wasm_f64x2_splat(0.0), c01 = wasm_f64x2_splat(0.0);
+    v128_t c10 = wasm_f64x2_splat(0.0), c11 = wasm_f64x2_splat(0.0);
+    v128_t c20 = wasm_f64x2_splat(0.0), c21 = wasm_f64x2_splat(0.0);
+    v128_t c30 = wasm_f64x2_splat(0.0), c31 = wasm_f64x2_splat(0.0);
+    
+    for (int p = 0; p < kc; p++) {
+        v128_t b0 = wasm_v128_load(b);
+        v128_t b1 = wasm_v128_load(b + 2);
+        
+        v128_t a0 = wasm_f64x2_splat(a[0]);
+        c00 = wasm_f64x2_add(c00, wasm_f64x2_mul(a0, b0));
+        c01 = wasm_f64x2_add(c01, wasm_f64x2_mul(a0, b1));
+        v128_t a1 = wasm_f64x2_splat(a[1]);
+        c10 = wasm_f64x2_add(c10, wasm_f64x2_mul(a1, b0));
+        c11 = wasm_f64x2_add(c11, wasm_f64x2_mul(a1, b1));
+        v128_t a2 = wasm_f64x2_splat(a[2]);
+        c20 = wasm_f64x2_add(c20, wasm_f64x2_mul(a2, b0));
+        c21 = wasm_f64x2_add(c21, wasm_f64x2_mul(a2, b1));
+        v128_t a3 = wasm_f64x2_splat(a[3]);
+        c30 = wasm_f64x2_add(c30, wasm_f64x2_mul(a3, b0));
+        c31 = wasm_f64x2_add(c31, wasm_f64x2_mul(a3, b1));
+        
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    
+    wasm_v128_store(&acc[0][0], c00); wasm_v128_store(&acc[0][2], c01);
+    wasm_v128_store(&acc[1][0], c10); wasm_v128_store(&acc[1][2], c11);
+    wasm_v128_store(&acc[2][0], c20); wasm_v128_store(&acc[2][2], c21);
+    wasm_v128_store(&acc[3][0], c30); wasm_v128_store(&acc[3][2], c31);
+#else
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < GEMM_MR; i++) {
+            double a_value = a[i];
+            for (int j = 0; j < GEMM_NR; j++) {
+                acc[i][j] += a_value * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+#endif
+    
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            C[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+// Blocked GEMM over rows [row_begin, row_end) of C, using caller-provided packing buffers
+// (packed_a holds mc * kc doubles, packed_b holds kc * nc doubles)
+static void gemm_blocked_rows(const double* A, const double* B, double* C, int n,
+                              GemmBlockParams params, int row_begin, int row_end,
+                              double* packed_a, double* packed_b) {
+    for (int i = row_begin; i < row_end; i++) {
+        for (int j = 0; j < n; j++) {
+            C[i * n + j] = 0.0;
+        }
+    }
+    
+    for (int jc = 0; jc < n; jc += params.nc) {
+        int nc = (n - jc < params.nc) ? n - jc : params.nc;
+        
+        for (int pc = 0; pc < n; pc += params.kc) {
+            int kc = (n - pc < params.kc) ? n - pc : params.kc;
+            gemm_pack_b(B, n, pc, jc, kc, nc, packed_b);
+            
+            for (int ic = row_begin; ic < row_end; ic += params.mc) {
+                int mc = (row_end - ic < params.mc) ? row_end - ic : params.mc;
+                gemm_pack_a(A, n, ic, pc, mc, kc, packed_a);
+                
+                // Macro-kernel: sweep register tiles over the packed block
+                for (int jr = 0; jr < nc; jr += GEMM_NR) {
+                    int cols = (nc - jr < GEMM_NR) ? nc - jr : GEMM_NR;
+                    for (int ir = 0; ir < mc; ir += GEMM_MR) {
+                        int rows = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;
+                        gemm_micro_kernel(kc, packed_a + ir * kc, packed_b + jr * kc,
+                                          C + (ic + ir) * n + jc + jr, n, rows, cols);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Cache-blocked matrix multiplication: C = A × B into a caller-provided C.
+// Pass nullptr for block_params to use the default (or auto-tuned) blocking.
+// Returns 0 on success, -1 on invalid arguments or allocation failure.
+EMSCRIPTEN_KEEPALIVE
+int multiply_matrices_blocked(const double* A, const double* B, double* C, int n,
+                              const GemmBlockParams* block_params) {
+    if (!A || !B || !C || n <= 0) return -1;
+    
+    GemmBlockParams params = block_params ? gemm_normalize_params(*block_params, n)
+                                          : gemm_default_params(n);
+    
+    double* packed_a = (double*)malloc(params.mc * params.kc * sizeof(double));
+    double* packed_b = (double*)malloc(params.kc * params.nc * sizeof(double));
+    if (!packed_a || !packed_b) {
+        if (packed_a) free(packed_a);
+        if (packed_b) free(packed_b);
+        return -1;
+    }
+    
+    gemm_blocked_rows(A, B, C, n, params, 0, n, packed_a, packed_b);
+    
+    free(packed_a);
+    free(packed_b);
+    
+    return 0;
+}
+
+// Multithreaded matrix multiplication: C = A × B.
+// C is split into bands of rows that are dealt out to the persistent thread pool
+// with work stealing; each worker packs into its own buffers. threads <= 0 uses
+// every pool thread. Without a -pthread build this runs on the calling thread.
+EMSCRIPTEN_KEEPALIVE
+double* multiply_matrices_parallel(double* A, double* B, int n, int threads) {
+    if (!A || !B || n <= 0) return nullptr;
+    
+    ThreadPool& pool = ThreadPool::instance();
+    if (threads <= 0 || threads > pool.max_threads()) threads = pool.max_threads();
+    
+    GemmBlockParams params = gemm_default_params(n);
+    int num_bands = (n + params.mc - 1) / params.mc;
+    if (threads > num_bands) threads = num_bands;
+    
+    double* C = (double*)malloc(n * n * sizeof(double));
+    size_t pack_size = params.mc * params.kc + params.kc * params.nc;
+    double* pack_buffers = (double*)malloc(threads * pack_size * sizeof(double));
+    if (!C || !pack_buffers) {
+        if (C) free(C);
+        if (pack_buffers) free(pack_buffers);
+        return nullptr;
+    }
+    
+    parallel_for(num_bands, threads, [&](int band, int worker) {
+        double* packed_a = pack_buffers + worker * pack_size;
+        double* packed_b = packed_a + params.mc * params.kc;
+        int row_begin = band * params.mc;
+        int row_end = (row_begin + params.mc < n) ? row_begin + params.mc : n;
+        gemm_blocked_rows(A, B, C, n, params, row_begin, row_end, packed_a, packed_b);
+    });
+    
+    free(pack_buffers);
+    
+    return C;
+}
+
+// Time a few candidate blockings on an n×n problem and keep the fastest as the
+// default for multiply_matrices / multiply_matrices_blocked. Returns the chosen kc.
+EMSCRIPTEN_KEEPALIVE
+int gemm_autotune(int n) {
+    if (n <= 0) return 0;
+    
+    static const GemmBlockParams candidates[] = {
+        {48, 128, 2048}, {96, 128, 2048}, {64, 256, 2048},
+        {96, 256, 2048}, {128, 256, 2048}, {192, 384, 2048}
+    };
+    int num_candidates = sizeof(candidates) / sizeof(candidates[0]);
+    
+    double* A = (double*)malloc(n * n * sizeof(double));
+    double* B = (double*)malloc(n * n * sizeof(double));
+    double* C = (double*)malloc(n * n * sizeof(double));
+    if (!A || !B || !C) {
+        if (A) free(A);
+        if (B) free(B);
+        if (C) free(C);
+        return 0;
+    }
+    
+    for (int i = 0; i < n * n; i++) {
+        A[i] = (double)(i % 17) * 0.25;
+        B[i] = (double)(i % 13) * 0.5;
+    }
+    
+    double best_time = 0.0;
+    GemmBlockParams best = candidates[0];
+    for (int c = 0; c < num_candidates; c++) {
+        double start = emscripten_get_now();
+        multiply_matrices_blocked(A, B, C, n, &candidates[c]);
+        double elapsed = emscripten_get_now() - start;
+        
+        if (c == 0 || elapsed < best_time) {
+            best_time = elapsed;
+            best = candidates[c];
+        }
+    }
+    
+    free(A);
+    free(B);
+    free(C);
+    
+    gemm_tuned_params = best;
+    return best.kc;
+}
+
 // Matrix multiplication: C = A × B
 EMSCRIPTEN_KEEPALIVE
 double* multiply_matrices(double* A, double* B, int n) {
@@ -28,13 +310,9 @@ double* multiply_matrices(double* A, double* B, int n) {
     double* C = (double*)malloc(n * n * sizeof(double));
     if (!C) return nullptr;
     
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            C[i * n + j] = 0;
-            for (int k = 0; k < n; k++) {
-                C[i * n + j] += A[i * n + k] * B[k * n + j];
-            }
-        }
+    if (multiply_matrices_blocked(A, B, C, n, nullptr) != 0) {
+        free(C);
+        return nullptr;
     }
     
     return C;
@@ -1,6 +1,853 @@
 #include <emscripten/emscripten.h>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "thread-pool.h"
+
+// Built-in integrand families
+#define INTEGRAND_TEST 0              // (x+1)^2, the benchmark function
+#define INTEGRAND_POLYNOMIAL 1        // c[0] + c[1]*x + ... + c[count-1]*x^(count-1)
+#define INTEGRAND_PIECEWISE_LINEAR 2  // linear interpolation through (x[i], y[i]), constant outside
+#define INTEGRAND_EXP_SIN 3           // amplitude * exp(rate*x) * sin(frequency*x + phase)
+
+// Multidimensional families (Genz test functions), integrated with integrate_monte_carlo
+#define INTEGRAND_GENZ_GAUSSIAN 4      // exp(-sum c[k]^2 * (x[k] - w[k])^2)
+#define INTEGRAND_GENZ_OSCILLATORY 5   // cos(2*pi*u + sum c[k] * x[k])
+
+// Integrand description handed out to JS by the integrand_create_* functions
+struct Integrand {
+    int kind;
+    int count;         // polynomial: coefficients; piecewise-linear: points; Genz: dimensions
+    double* data;      // polynomial: c[0..count); piecewise-linear: x[0..count) then y[0..count);
+                       // Genz: c[0..count) then (gaussian) w[0..count)
+    double params[4];  // exp-sin: amplitude, rate, frequency, phase; Genz oscillatory: u
+};
+
+// Integrand functors.
+// Each family is a small type with an inlined scalar evaluation and, in SIMD
+// builds, a two-lane evaluation. The quadrature kernels are templates over these
+// types, so every family gets its own specialized loop instead of an indirect
+// call per sample point.
+struct TestIntegrand {
+    double operator()(double x) const {
+        return x * x + 2.0 * x + 1.0; // (x+1)^2
+    }
+#ifdef __wasm_simd128__
+    v128_t operator()(v128_t x) const {
+        return wasm_f64x2_add(wasm_f64x2_add(wasm_f64x2_mul(x, x), wasm_f64x2_mul(wasm_f64x2_splat(2.0), x)),
+                              wasm_f64x2_splat(1.0));
+    }
+#endif
+};
+
+struct PolynomialIntegrand {
+    const double* coefficients;
+    int count;
+    
+    // Horner's scheme
+    double operator()(double x) const {
+        double result = 0.0;
+        for (int k = count - 1; k >= 0; k--) {
+            result = result * x + coefficients[k];
+        }
+        return result;
+    }
+#ifdef __wasm_simd128__
+    v128_t operator()(v128_t x) const {
+        v128_t result = wasm_f64x2_splat(0.0);
+        for (int k = count - 1; k >= 0; k--) {
+            result = wasm_f64x2_add(wasm_f64x2_mul(result, x), wasm_f64x2_splat(coefficients[k]));
+        }
+        return result;
+    }
+#endif
+};
+
+struct PiecewiseLinearIntegrand {
+    const double* xs;
+    const double* ys;
+    int count;
+    
+    double operator()(double x) const {
+        if (x <= xs[0]) return ys[0];
+        if (x >= xs[count - 1]) return ys[count - 1];
+        
+        // Binary search for the segment [xs[lo], xs[lo + 1]] containing x
+        int lo = 0;
+        int hi = count - 1;
+        while (hi - lo > 1) {
+            int mid = (lo + hi) / 2;
+            if (xs[mid] <= x) lo = mid; else hi = mid;
+        }
+        double t = (x - xs[lo]) / (xs[lo + 1] - xs[lo]);
+        return ys[lo] + t * (ys[lo + 1] - ys[lo]);
+    }
+#ifdef __wasm_simd128__
+    v128_t operator()(v128_t x) const {
+        return wasm_f64x2_make((*this)(wasm_f64x2_extract_lane(x, 0)), (*this)(wasm_f64x2_extract_lane(x, 1)));
+    }
+#endif
+};
+
+struct ExpSinIntegrand {
+    double amplitude;
+    double rate;
+    double frequency;
+    double phase;
+    
+    double operator()(double x) const {
+        return amplitude * exp(rate * x) * sin(frequency * x + phase);
+    }
+#ifdef __wasm_simd128__
+    v128_t operator()(v128_t x) const {
+        return wasm_f64x2_make((*this)(wasm_f64x2_extract_lane(x, 0)), (*this)(wasm_f64x2_extract_lane(x, 1)));
+    }
+#endif
+};
+
+// Call visit(functor) with the functor matching the integrand; nullptr means the test function
+template <typename Visitor>
+static double dispatch_integrand(const Integrand* integrand, Visitor visit) {
+    if (!integrand) return visit(TestIntegrand());
+    
+    switch (integrand->kind) {
+        case INTEGRAND_POLYNOMIAL: {
+            PolynomialIntegrand f = {integrand->data, integrand->count};
+            return visit(f);
+        }
+        case INTEGRAND_PIECEWISE_LINEAR: {
+            PiecewiseLinearIntegrand f = {integrand->data, integrand->data + integrand->count, integrand->count};
+            return visit(f);
+        }
+        case INTEGRAND_EXP_SIN: {
+            ExpSinIntegrand f = {integrand->params[0], integrand->params[1], integrand->params[2], integrand->params[3]};
+            return visit(f);
+        }
+        default:
+            return visit(TestIntegrand());
+    }
+}
+
+// Sum f(a + i*h) for i = first, first + step, ... while i < end
+template <typename F>
+static double uniform_sum(const F& f, double a, double h, int first, int end, int step) {
+#ifdef __wasm_simd128__
+    // Two f64x2 accumulators: four sample points per iteration
+    v128_t acc0 = wasm_f64x2_splat(0.0);
+    v128_t acc1 = wasm_f64x2_splat(0.0);
+    v128_t va = wasm_f64x2_splat(a);
+    v128_t vh = wasm_f64x2_splat(h);
+    
+    int i = first;
+    for (; i + 3 * step < end; i += 4 * step) {
+        v128_t idx0 = wasm_f64x2_make((double)i, (double)(i + step));
+        v128_t idx1 = wasm_f64x2_make((double)(i + 2 * step), (double)(i + 3 * step));
+        acc0 = wasm_f64x2_add(acc0, f(wasm_f64x2_add(va, wasm_f64x2_mul(idx0, vh))));
+        acc1 = wasm_f64x2_add(acc1, f(wasm_f64x2_add(va, wasm_f64x2_mul(idx1, vh))));
+    }
+    
+    v128_t acc = wasm_f64x2_add(acc0, acc1);
+    double sum = wasm_f64x2_extract_lane(acc, 0) + wasm_f64x2_extract_lane(acc, 1);
+    for (; i < end; i += step) {
+        sum += f(a + i * h);
+    }
+    
+    return sum;
+#else
+    // Four scalar accumulators break the single add dependency chain
+    double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+    int i = first;
+    for (; i + 3 * step < end; i += 4 * step) {
+        sum0 += f(a + i * h);
+        sum1 += f(a + (i + step) * h);
+        sum2 += f(a + (i + 2 * step) * h);
+        sum3 += f(a + (i + 3 * step) * h);
+    }
+    
+    double sum = (sum0 + sum1) + (sum2 + sum3);
+    for (; i < end; i += step) {
+        double x = a + i * h;
+        sum += f(x);
+    }
+    return sum;
+#endif
+}
+
+// Trapezoidal rule with n intervals
+template <typename F>
+static double trapezoid_rule(const F& f, double a, double b, int n) {
+    double h = (b - a) / n;
+    double sum = 0.5 * (f(a) + f(b));
+    sum += uniform_sum(f, a, h, 1, n, 1);
+    return sum * h;
+}
+
+// Simpson's rule with n intervals (n even)
+template <typename F>
+static double simpson_rule(const F& f, double a, double b, int n) {
+    double h = (b - a) / n;
+    double sum = f(a) + f(b);
+    sum += 4.0 * uniform_sum(f, a, h, 1, n, 2); // odd-indexed terms
+    sum += 2.0 * uniform_sum(f, a, h, 2, n, 2); // even-indexed terms
+    return sum * h / 3.0;
+}
+
+// Summation modes for the parallel reduction
+#define SUMMATION_NAIVE 0
+#define SUMMATION_COMPENSATED 1 // Kahan-Babuska-Neumaier
+#define SUMMATION_PAIRWISE 2
+
+// Below this many points a pairwise sum falls back to the unrolled loop
+#define PAIRWISE_BLOCK_SIZE 256
+
+// Points per chunk below which the parallel reduction uses fewer chunks
+#define INTEGRATION_MIN_CHUNK 4096
+
+// Neumaier-compensated running sum
+struct CompensatedSum {
+    double sum = 0.0;
+    double compensation = 0.0;
+    
+    void add(double x) {
+        double t = sum + x;
+        if (fabs(sum) >= fabs(x)) {
+            compensation += (sum - t) + x;
+        } else {
+            compensation += (x - t) + sum;
+        }
+        sum = t;
+    }
+    
+    double value() const { return sum + compensation; }
+};
+
+// Compensated sum of f(a + i*h) for i in [first, end), with four independent
+// (sum, compensation) lanes
+template <typename F>
+static double compensated_sum(const F& f, double a, double h, int first, int end) {
+    CompensatedSum total;
+    int i = first;
+    
+#ifdef __wasm_simd128__
+    v128_t sum0 = wasm_f64x2_splat(0.0);
+    v128_t sum1 = wasm_f64x2_splat(0.0);
+    v128_t comp0 = wasm_f64x2_splat(0.0);
+    v128_t comp1 = wasm_f64x2_splat(0.0);
+    v128_t va = wasm_f64x2_splat(a);
+    v128_t vh = wasm_f64x2_splat(h);
+    
+    for (; i + 3 < end; i += 4) {
+        v128_t x0 = f(wasm_f64x2_add(va, wasm_f64x2_mul(wasm_f64x2_make((double)i, (double)(i + 1)), vh)));
+        v128_t x1 = f(wasm_f64x2_add(va, wasm_f64x2_mul(wasm_f64x2_make((double)(i + 2), (double)(i + 3)), vh)));
+        
+        v128_t t0 = wasm_f64x2_add(sum0, x0);
+        v128_t t1 = wasm_f64x2_add(sum1, x1);
+        v128_t big0 = wasm_f64x2_ge(wasm_f64x2_abs(sum0), wasm_f64x2_abs(x0));
+        v128_t big1 = wasm_f64x2_ge(wasm_f64x2_abs(sum1), wasm_f64x2_abs(x1));
+        comp0 = wasm_f64x2_add(comp0, wasm_v128_bitselect(
+            wasm_f64x2_add(wasm_f64x2_sub(sum0, t0), x0), wasm_f64x2_add(wasm_f64x2_sub(x0, t0), sum0), big0));
+        comp1 = wasm_f64x2_add(comp1, wasm_v128_bitselect(
+            wasm_f64x2_add(wasm_f64x2_sub(sum1, t1), x1), wasm_f64x2_add(wasm_f64x2_sub(x1, t1), sum1), big1));
+        sum0 = t0;
+        sum1 = t1;
+    }
+    
+    total.add(wasm_f64x2_extract_lane(sum0, 0));
+    total.add(wasm_f64x2_extract_lane(sum0, 1));
+    total.add(wasm_f64x2_extract_lane(sum1, 0));
+    total.add(wasm_f64x2_extract_lane(sum1, 1));
+    total.compensation += (wasm_f64x2_extract_lane(comp0, 0) + wasm_f64x2_extract_lane(comp0, 1)) +
+                          (wasm_f64x2_extract_lane(comp1, 0) + wasm_f64x2_extract_lane(comp1, 1));
+#else
+    CompensatedSum lanes[4];
+    for (; i + 3 < end; i += 4) {
+        lanes[0].add(f(a + i * h));
+        lanes[1].add(f(a + (i + 1) * h));
+        lanes[2].add(f(a + (i + 2) * h));
+        lanes[3].add(f(a + (i + 3) * h));
+    }
+    
+    for (int lane = 0; lane < 4; lane++) {
+        total.add(lanes[lane].sum);
+        total.compensation += lanes[lane].compensation;
+    }
+#endif
+    
+    for (; i < end; i++) {
+        total.add(f(a + i * h));
+    }
+    
+    return total.value();
+}
+
+// Pairwise (cascade) sum of f(a + i*h) for i in [first, end): error grows with
+// log(n) instead of n
+template <typename F>
+static double pairwise_sum(const F& f, double a, double h, int first, int end) {
+    if (end - first <= PAIRWISE_BLOCK_SIZE) {
+        return uniform_sum(f, a, h, first, end, 1);
+    }
+    
+    int mid = first + (end - first) / 2;
+    return pairwise_sum(f, a, h, first, mid) + pairwise_sum(f, a, h, mid, end);
+}
+
+// Sum f(a + i*h) for i in [first, end) with the requested summation mode
+template <typename F>
+static double chunk_sum(const F& f, double a, double h, int first, int end, int summation) {
+    switch (summation) {
+        case SUMMATION_COMPENSATED:
+            return compensated_sum(f, a, h, first, end);
+        case SUMMATION_PAIRWISE:
+            return pairwise_sum(f, a, h, first, end);
+        default:
+            return uniform_sum(f, a, h, first, end, 1);
+    }
+}
+
+// Combine per-chunk partial sums in chunk order, so the result does not depend
+// on which worker computed which chunk
+static double combine_partials(const double* partials, int count, int summation) {
+    if (summation == SUMMATION_COMPENSATED) {
+        CompensatedSum total;
+        for (int i = 0; i < count; i++) total.add(partials[i]);
+        return total.value();
+    }
+    if (summation == SUMMATION_PAIRWISE && count > 1) {
+        int half = count / 2;
+        return combine_partials(partials, half, summation) +
+               combine_partials(partials + half, count - half, summation);
+    }
+    
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += partials[i];
+    return sum;
+}
+
+// Trapezoidal rule with the n - 1 interior points split into chunks that are
+// summed on the thread pool. The chunking depends only on n and threads, so a
+// fixed thread count always gives a bit-identical result.
+template <typename F>
+static double trapezoid_rule_parallel(const F& f, double a, double b, int n, int threads,
+                                      int summation, double* partials) {
+    double h = (b - a) / n;
+    int interior = n - 1;
+    int num_chunks = partials ? threads * 4 : 1;
+    if (num_chunks > interior / INTEGRATION_MIN_CHUNK) num_chunks = interior / INTEGRATION_MIN_CHUNK;
+    if (num_chunks < 1) num_chunks = 1;
+    
+    double sum;
+    if (num_chunks == 1) {
+        sum = chunk_sum(f, a, h, 1, n, summation);
+    } else {
+        parallel_for(num_chunks, threads, [&](int chunk, int) {
+            int first = 1 + (int)((long long)interior * chunk / num_chunks);
+            int end = 1 + (int)((long long)interior * (chunk + 1) / num_chunks);
+            partials[chunk] = chunk_sum(f, a, h, first, end, summation);
+        });
+        sum = combine_partials(partials, num_chunks, summation);
+    }
+    
+    return (sum + 0.5 * (f(a) + f(b))) * h;
+}
+
+// Evaluate f at two points; one two-lane evaluation in SIMD builds
+template <typename F>
+static inline void evaluate_pair(const F& f, double x0, double x1, double* y0, double* y1) {
+#ifdef __wasm_simd128__
+    v128_t y = f(wasm_f64x2_make(x0, x1));
+    *y0 = wasm_f64x2_extract_lane(y, 0);
+    *y1 = wasm_f64x2_extract_lane(y, 1);
+#else
+    *y0 = f(x0);
+    *y1 = f(x1);
+#endif
+}
+
+#define GAUSS_LEGENDRE_MAX_ORDER 64
+#define ROMBERG_MAX_LEVELS 30
+
+// Nodes and weights of an n-point Gauss-Legendre rule on [-1, 1]. Only the
+// (n + 1) / 2 non-negative nodes are stored; the rule is symmetric about 0.
+struct GaussLegendreRule {
+    int order;
+    double nodes[(GAUSS_LEGENDRE_MAX_ORDER + 1) / 2];
+    double weights[(GAUSS_LEGENDRE_MAX_ORDER + 1) / 2];
+};
+
+// Rules are computed on first use and kept for the lifetime of the module
+static GaussLegendreRule* gauss_legendre_cache[GAUSS_LEGENDRE_MAX_ORDER + 1];
+
+// Find the roots of P_n by Newton iteration from the Tricomi initial guesses
+static const GaussLegendreRule* get_gauss_legendre_rule(int order) {
+    if (order < 1 || order > GAUSS_LEGENDRE_MAX_ORDER) return nullptr;
+    if (gauss_legendre_cache[order]) return gauss_legendre_cache[order];
+    
+    GaussLegendreRule* rule = (GaussLegendreRule*)malloc(sizeof(GaussLegendreRule));
+    if (!rule) return nullptr;
+    rule->order = order;
+    
+    for (int i = 0; i < (order + 1) / 2; i++) {
+        double x = cos(M_PI * (i + 0.75) / (order + 0.5));
+        double derivative = 1.0;
+        
+        for (int iteration = 0; iteration < 100; iteration++) {
+            // Three-term recurrence for P_n(x) and P_{n-1}(x)
+            double p_prev = 1.0;
+            double p = x;
+            for (int k = 2; k <= order; k++) {
+                double p_next = ((2 * k - 1) * x * p - (k - 1) * p_prev) / k;
+                p_prev = p;
+                p = p_next;
+            }
+            
+            derivative = order * (x * p - p_prev) / (x * x - 1.0);
+            double step = p / derivative;
+            x -= step;
+            if (fabs(step) < 1e-16) break;
+        }
+        
+        // An odd order has its middle node at exactly 0
+        if (order % 2 == 1 && i == order / 2) x = 0.0;
+        if (order == 1) derivative = 1.0;
+        
+        rule->nodes[i] = x;
+        rule->weights[i] = 2.0 / ((1.0 - x * x) * derivative * derivative);
+    }
+    
+    gauss_legendre_cache[order] = rule;
+    return rule;
+}
+
+// Apply a Gauss-Legendre rule on [a, b]
+template <typename F>
+static double gauss_legendre_rule(const F& f, const GaussLegendreRule* rule, double a, double b) {
+    double center = 0.5 * (a + b);
+    double half_length = 0.5 * (b - a);
+    int pairs = rule->order / 2;
+    double sum = 0.0;
+    
+    for (int i = 0; i < pairs; i++) {
+        double offset = half_length * rule->nodes[i];
+        double lower, upper;
+        evaluate_pair(f, center - offset, center + offset, &lower, &upper);
+        sum += rule->weights[i] * (lower + upper);
+    }
+    if (rule->order % 2 == 1) {
+        sum += rule->weights[pairs] * f(center);
+    }
+    
+    return sum * half_length;
+}
+
+// Romberg integration: each level halves h, reusing the previous trapezoidal sum
+// so only the new midpoints are evaluated, then Richardson-extrapolates the row
+template <typename F>
+static double romberg_rule(const F& f, double a, double b, int levels) {
+    double row[ROMBERG_MAX_LEVELS + 1];
+    double h = b - a;
+    double trapezoid = 0.5 * h * (f(a) + f(b));
+    row[0] = trapezoid;
+    
+    int intervals = 1;
+    for (int level = 1; level <= levels; level++) {
+        // T(h/2) = T(h)/2 + h/2 * sum of f at the midpoints of the current intervals
+        intervals *= 2;
+        h *= 0.5;
+        trapezoid = 0.5 * trapezoid + h * uniform_sum(f, a, h, 1, intervals, 2);
+        
+        double previous = row[0];
+        row[0] = trapezoid;
+        double factor = 1.0;
+        for (int k = 1; k <= level; k++) {
+            factor *= 4.0;
+            double extrapolated = row[k - 1] + (row[k - 1] - previous) / (factor - 1.0);
+            if (k < level) previous = row[k];
+            row[k] = extrapolated;
+        }
+    }
+    
+    return row[levels];
+}
+
+// 15-point Kronrod nodes/weights and the embedded 7-point Gauss weights (QUADPACK qk15).
+// Nodes are listed from the outermost inwards; the Gauss nodes are the odd entries.
+static const double kronrod_nodes[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+};
+static const double kronrod_weights[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+static const double gauss7_weights[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+};
+
+// One subinterval of the adaptive integration
+struct QuadInterval {
+    double a;
+    double b;
+    double value;
+    double error;
+};
+
+// Apply the G7-K15 rule on [a, b]: value is the Kronrod estimate, error is the
+// QUADPACK-scaled difference between the Kronrod and Gauss estimates
+template <typename F>
+static QuadInterval gauss_kronrod_15(const F& f, double a, double b) {
+    double center = 0.5 * (a + b);
+    double half_length = 0.5 * (b - a);
+    
+    double f_center = f(center);
+    double kronrod = f_center * kronrod_weights[7];
+    double gauss = f_center * gauss7_weights[3];
+    double abs_kronrod = fabs(kronrod);
+    double f_lower[7];
+    double f_upper[7];
+    
+    for (int j = 0; j < 7; j++) {
+        double offset = half_length * kronrod_nodes[j];
+        evaluate_pair(f, center - offset, center + offset, &f_lower[j], &f_upper[j]);
+        double pair_sum = f_lower[j] + f_upper[j];
+        kronrod += kronrod_weights[j] * pair_sum;
+        abs_kronrod += kronrod_weights[j] * (fabs(f_lower[j]) + fabs(f_upper[j]));
+        if (j % 2 == 1) gauss += gauss7_weights[j / 2] * pair_sum;
+    }
+    
+    // Integral of |f - mean| measures how smooth f is on the interval
+    double mean = kronrod * 0.5;
+    double abs_deviation = kronrod_weights[7] * fabs(f_center - mean);
+    for (int j = 0; j < 7; j++) {
+        abs_deviation += kronrod_weights[j] * (fabs(f_lower[j] - mean) + fabs(f_upper[j] - mean));
+    }
+    
+    QuadInterval interval;
+    interval.a = a;
+    interval.b = b;
+    interval.value = kronrod * half_length;
+    
+    double error = fabs((kronrod - gauss) * half_length);
+    abs_deviation *= fabs(half_length);
+    abs_kronrod *= fabs(half_length);
+    if (abs_deviation != 0.0 && error != 0.0) {
+        double scale = pow(200.0 * error / abs_deviation, 1.5);
+        error = abs_deviation * (scale < 1.0 ? scale : 1.0);
+    }
+    if (abs_kronrod > 2.2250738585072014e-308 / (50.0 * 2.220446049250313e-16)) {
+        double floor_error = 50.0 * 2.220446049250313e-16 * abs_kronrod;
+        if (error < floor_error) error = floor_error;
+    }
+    interval.error = error;
+    
+    return interval;
+}
+
+// Global adaptive integration: always bisect the interval with the largest error
+// estimate (kept at the top of a max-heap) until the total error meets the tolerance
+// or the evaluation budget runs out. Writes [value, error, evaluations].
+template <typename F>
+static void integrate_adaptive_kernel(const F& f, double a, double b, double abs_tol, double rel_tol,
+                                      int max_evals, double* results) {
+    auto by_error = [](const QuadInterval& x, const QuadInterval& y) { return x.error < y.error; };
+    
+    // Subdivide the ordered interval; reversed bounds only flip the sign
+    double sign = 1.0;
+    if (a > b) {
+        std::swap(a, b);
+        sign = -1.0;
+    }
+    
+    std::vector<QuadInterval> heap;
+    heap.push_back(gauss_kronrod_15(f, a, b));
+    int evals = 15;
+    double value = heap[0].value;
+    double error = heap[0].error;
+    
+    while (evals + 30 <= max_evals) {
+        double tolerance = std::max(abs_tol, rel_tol * fabs(value));
+        if (error <= tolerance) break;
+        
+        std::pop_heap(heap.begin(), heap.end(), by_error);
+        QuadInterval worst = heap.back();
+        heap.pop_back();
+        
+        double mid = 0.5 * (worst.a + worst.b);
+        if (mid <= worst.a || mid >= worst.b) {
+            // Interval can no longer be split in double precision
+            heap.push_back(worst);
+            std::push_heap(heap.begin(), heap.end(), by_error);
+            break;
+        }
+        
+        QuadInterval left = gauss_kronrod_15(f, worst.a, mid);
+        QuadInterval right = gauss_kronrod_15(f, mid, worst.b);
+        evals += 30;
+        
+        value += left.value + right.value - worst.value;
+        error += left.error + right.error - worst.error;
+        
+        heap.push_back(left);
+        std::push_heap(heap.begin(), heap.end(), by_error);
+        heap.push_back(right);
+        std::push_heap(heap.begin(), heap.end(), by_error);
+    }
+    
+    // Re-sum to drop the rounding drift of the running totals
+    value = 0.0;
+    error = 0.0;
+    for (const QuadInterval& interval : heap) {
+        value += interval.value;
+        error += interval.error;
+    }
+    
+    results[0] = sign * value;
+    results[1] = error;
+    results[2] = (double)evals;
+}
+
+// Monte Carlo / quasi-Monte Carlo integration over a box
+#define MC_SAMPLER_PRNG 0    // counter-based pseudo-random points
+#define MC_SAMPLER_HALTON 1  // Halton sequence, random-shifted (Cranley-Patterson) per replicate
+#define MC_SAMPLER_SOBOL 2   // Sobol sequence, digitally shifted per replicate
+
+#define MC_MAX_DIMS 16
+#define MC_MAX_REPLICATES 64
+#define MC_CHUNK 256  // points generated and evaluated per batch
+
+// Multidimensional functors evaluate a batch of points stored dimension-major:
+// coordinate k of point j is points[k * MC_CHUNK + j]
+struct GenzGaussianIntegrand {
+    const double* c;
+    const double* w;
+    int dims;
+    
+    void operator()(const double* points, int count, double* values) const {
+        int j = 0;
+#ifdef __wasm_simd128__
+        for (; j + 1 < count; j += 2) {
+            v128_t exponent = wasm_f64x2_splat(0.0);
+            for (int k = 0; k < dims; k++) {
+                v128_t x = wasm_v128_load(points + k * MC_CHUNK + j);
+                v128_t scaled = wasm_f64x2_mul(wasm_f64x2_splat(c[k]), wasm_f64x2_sub(x, wasm_f64x2_splat(w[k])));
+                exponent = wasm_f64x2_add(exponent, wasm_f64x2_mul(scaled, scaled));
+            }
+            values[j] = exp(-wasm_f64x2_extract_lane(exponent, 0));
+            values[j + 1] = exp(-wasm_f64x2_extract_lane(exponent, 1));
+        }
+#endif
+        for (; j < count; j++) {
+            double exponent = 0.0;
+            for (int k = 0; k < dims; k++) {
+                double scaled = c[k] * (points[k * MC_CHUNK + j] - w[k]);
+                exponent += scaled * scaled;
+            }
+            values[j] = exp(-exponent);
+        }
+    }
+};
+
+struct GenzOscillatoryIntegrand {
+    const double* c;
+    double u;
+    int dims;
+    
+    void operator()(const double* points, int count, double* values) const {
+        double offset = 2.0 * M_PI * u;
+        int j = 0;
+#ifdef __wasm_simd128__
+        for (; j + 1 < count; j += 2) {
+            v128_t phase = wasm_f64x2_splat(offset);
+            for (int k = 0; k < dims; k++) {
+                v128_t x = wasm_v128_load(points + k * MC_CHUNK + j);
+                phase = wasm_f64x2_add(phase, wasm_f64x2_mul(wasm_f64x2_splat(c[k]), x));
+            }
+            values[j] = cos(wasm_f64x2_extract_lane(phase, 0));
+            values[j + 1] = cos(wasm_f64x2_extract_lane(phase, 1));
+        }
+#endif
+        for (; j < count; j++) {
+            double phase = offset;
+            for (int k = 0; k < dims; k++) {
+                phase += c[k] * points[k * MC_CHUNK + j];
+            }
+            values[j] = cos(phase);
+        }
+    }
+};
+
+// Call visit(functor) for a multidimensional integrand
+template <typename Visitor>
+static void dispatch_multi_integrand(const Integrand* integrand, Visitor visit) {
+    if (integrand->kind == INTEGRAND_GENZ_GAUSSIAN) {
+        GenzGaussianIntegrand f = {integrand->data, integrand->data + integrand->count, integrand->count};
+        visit(f);
+    } else {
+        GenzOscillatoryIntegrand f = {integrand->data, integrand->params[0], integrand->count};
+        visit(f);
+    }
+}
+
+// Counter-based generator: the value for (key, counter) is a splitmix64 hash, so
+// any point of any stream can be produced directly and threads need no shared state
+static inline uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static inline uint64_t counter_random(uint64_t key, uint64_t counter) {
+    return mix64(key + (counter + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+// Uniform double in [0, 1) with 53 random bits
+static inline double counter_uniform(uint64_t key, uint64_t counter) {
+    return (double)(counter_random(key, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// First MC_MAX_DIMS primes, the Halton bases
+static const int halton_primes[MC_MAX_DIMS] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+
+// Van der Corput radical inverse of index in the given base
+static inline double radical_inverse(int base, uint32_t index) {
+    double inverse_base = 1.0 / base;
+    double scale = inverse_base;
+    double result = 0.0;
+    while (index > 0) {
+        result += (index % base) * scale;
+        index /= base;
+        scale *= inverse_base;
+    }
+    return result;
+}
+
+// Sobol primitive polynomials and initial direction numbers for dimensions 2..16
+// (Joe & Kuo, new-joe-kuo-6.21201): degree s, coefficients a, m[0..s)
+struct SobolPolynomial {
+    int degree;
+    int coefficients;
+    uint32_t initial[6];
+};
+
+static const SobolPolynomial sobol_polynomials[MC_MAX_DIMS - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}}
+};
+
+// 32-bit direction numbers, built on first use
+static uint32_t sobol_directions[MC_MAX_DIMS][32];
+static bool sobol_ready = false;
+
+static void init_sobol_directions() {
+    if (sobol_ready) return;
+    
+    for (int bit = 0; bit < 32; bit++) {
+        sobol_directions[0][bit] = 1u << (31 - bit);
+    }
+    
+    for (int k = 1; k < MC_MAX_DIMS; k++) {
+        const SobolPolynomial& poly = sobol_polynomials[k - 1];
+        uint32_t* v = sobol_directions[k];
+        int s = poly.degree;
+        
+        for (int bit = 0; bit < 32; bit++) {
+            if (bit < s) {
+                v[bit] = poly.initial[bit] << (31 - bit);
+                continue;
+            }
+            v[bit] = v[bit - s] ^ (v[bit - s] >> s);
+            for (int j = 1; j < s; j++) {
+                if ((poly.coefficients >> (s - 1 - j)) & 1) v[bit] ^= v[bit - j];
+            }
+        }
+    }
+    
+    sobol_ready = true;
+}
+
+// Sampling setup shared by all workers
+struct MonteCarloSampler {
+    int sampler;
+    int dims;
+    double lower[MC_MAX_DIMS];
+    double width[MC_MAX_DIMS];
+    uint64_t keys[MC_MAX_REPLICATES];                  // PRNG stream per replicate
+    double shifts[MC_MAX_REPLICATES][MC_MAX_DIMS];     // Halton random shifts
+    uint32_t digital_shifts[MC_MAX_REPLICATES][MC_MAX_DIMS]; // Sobol digital shifts
+};
+
+// Write points [start, start + count) of a replicate into points (dimension-major),
+// mapped from the unit cube onto the integration box
+static void generate_points(const MonteCarloSampler& ms, int replicate, uint32_t start, int count, double* points) {
+    const double to_unit = 1.0 / 4294967296.0;
+    
+    for (int k = 0; k < ms.dims; k++) {
+        double* out = points + k * MC_CHUNK;
+        double lower = ms.lower[k];
+        double width = ms.width[k];
+        
+        switch (ms.sampler) {
+            case MC_SAMPLER_HALTON: {
+                double shift = ms.shifts[replicate][k];
+                for (int j = 0; j < count; j++) {
+                    double u = radical_inverse(halton_primes[k], start + j + 1) + shift;
+                    if (u >= 1.0) u -= 1.0;
+                    out[j] = lower + width * u;
+                }
+                break;
+            }
+            case MC_SAMPLER_SOBOL: {
+                // Gray-code order: point i differs from point i-1 by one direction number
+                const uint32_t* v = sobol_directions[k];
+                uint32_t x = 0;
+                uint32_t gray = start ^ (start >> 1);
+                for (int bit = 0; gray; bit++, gray >>= 1) {
+                    if (gray & 1) x ^= v[bit];
+                }
+                uint32_t shift = ms.digital_shifts[replicate][k];
+                for (int j = 0; j < count; j++) {
+                    if (j > 0) x ^= v[__builtin_ctz(start + j)];
+                    out[j] = lower + width * ((double)(x ^ shift) * to_unit);
+                }
+                break;
+            }
+            default: {
+                uint64_t key = ms.keys[replicate];
+                for (int j = 0; j < count; j++) {
+                    uint64_t counter = (uint64_t)(start + j) * ms.dims + k;
+                    out[j] = lower + width * counter_uniform(key, counter);
+                }
+                break;
+            }
+        }
+    }
+}
 
 extern "C" {
 
@@ -8,7 +855,7 @@ extern "C" {
 // Analytical solution: ∫(x+1)^2 dx = (x+1)^3/3
 // From 0 to 1: (2)^3/3 - (1)^3/3 = 8/3 - 1/3 = 7/3 ≈ 2.333333
 double test_function(double x) {
-    return x * x + 2.0 * x + 1.0; // (x+1)^2
+    return TestIntegrand()(x);
 }
 
 // Analytical solution for comparison
@@ -24,38 +871,342 @@ EMSCRIPTEN_KEEPALIVE
 double trapezoidal_integration(double a, double b, int n) {
     if (n <= 0) return 0.0;
     
-    double h = (b - a) / n;
-    double sum = 0.5 * (test_function(a) + test_function(b));
+    return trapezoid_rule(TestIntegrand(), a, b, n);
+}
+
+// Simpson's rule for numerical integration (more accurate)
+EMSCRIPTEN_KEEPALIVE
+double simpson_integration(double a, double b, int n) {
+    if (n <= 0 || n % 2 != 0) return 0.0; // n must be even for Simpson's rule
     
-    for (int i = 1; i < n; i++) {
-        double x = a + i * h;
-        sum += test_function(x);
+    return simpson_rule(TestIntegrand(), a, b, n);
+}
+
+// Create a polynomial integrand c[0] + c[1]*x + ... (coefficients are copied)
+EMSCRIPTEN_KEEPALIVE
+Integrand* integrand_create_polynomial(const double* coefficients, int count) {
+    if (!coefficients || count <= 0) return nullptr;
+    
+    Integrand* integrand = (Integrand*)calloc(1, sizeof(Integrand));
+    if (!integrand) return nullptr;
+    
+    integrand->data = (double*)malloc(count * sizeof(double));
+    if (!integrand->data) {
+        free(integrand);
+        return nullptr;
     }
     
-    return sum * h;
+    integrand->kind = INTEGRAND_POLYNOMIAL;
+    integrand->count = count;
+    memcpy(integrand->data, coefficients, count * sizeof(double));
+    
+    return integrand;
 }
 
-// Simpson's rule for numerical integration (more accurate)
+// Create a piecewise-linear integrand through (xs[i], ys[i]); xs must be strictly
+// increasing. Values are held constant beyond the first and last points.
 EMSCRIPTEN_KEEPALIVE
-double simpson_integration(double a, double b, int n) {
+Integrand* integrand_create_piecewise_linear(const double* xs, const double* ys, int count) {
+    if (!xs || !ys || count <= 0) return nullptr;
+    for (int i = 1; i < count; i++) {
+        if (!(xs[i] > xs[i - 1])) return nullptr;
+    }
+    
+    Integrand* integrand = (Integrand*)calloc(1, sizeof(Integrand));
+    if (!integrand) return nullptr;
+    
+    integrand->data = (double*)malloc(2 * count * sizeof(double));
+    if (!integrand->data) {
+        free(integrand);
+        return nullptr;
+    }
+    
+    integrand->kind = INTEGRAND_PIECEWISE_LINEAR;
+    integrand->count = count;
+    memcpy(integrand->data, xs, count * sizeof(double));
+    memcpy(integrand->data + count, ys, count * sizeof(double));
+    
+    return integrand;
+}
+
+// Create an integrand amplitude * exp(rate*x) * sin(frequency*x + phase)
+EMSCRIPTEN_KEEPALIVE
+Integrand* integrand_create_exp_sin(double amplitude, double rate, double frequency, double phase) {
+    Integrand* integrand = (Integrand*)calloc(1, sizeof(Integrand));
+    if (!integrand) return nullptr;
+    
+    integrand->kind = INTEGRAND_EXP_SIN;
+    integrand->params[0] = amplitude;
+    integrand->params[1] = rate;
+    integrand->params[2] = frequency;
+    integrand->params[3] = phase;
+    
+    return integrand;
+}
+
+// Create a Genz gaussian integrand exp(-sum c[k]^2 * (x[k] - w[k])^2) in dims dimensions
+EMSCRIPTEN_KEEPALIVE
+Integrand* integrand_create_genz_gaussian(int dims, const double* c, const double* w) {
+    if (dims <= 0 || dims > MC_MAX_DIMS || !c || !w) return nullptr;
+    
+    Integrand* integrand = (Integrand*)calloc(1, sizeof(Integrand));
+    double* data = (double*)malloc(2 * dims * sizeof(double));
+    if (!integrand || !data) {
+        free(integrand);
+        free(data);
+        return nullptr;
+    }
+    
+    memcpy(data, c, dims * sizeof(double));
+    memcpy(data + dims, w, dims * sizeof(double));
+    integrand->kind = INTEGRAND_GENZ_GAUSSIAN;
+    integrand->count = dims;
+    integrand->data = data;
+    
+    return integrand;
+}
+
+// Create a Genz oscillatory integrand cos(2*pi*u + sum c[k] * x[k]) in dims dimensions
+EMSCRIPTEN_KEEPALIVE
+Integrand* integrand_create_genz_oscillatory(int dims, const double* c, double u) {
+    if (dims <= 0 || dims > MC_MAX_DIMS || !c) return nullptr;
+    
+    Integrand* integrand = (Integrand*)calloc(1, sizeof(Integrand));
+    double* data = (double*)malloc(dims * sizeof(double));
+    if (!integrand || !data) {
+        free(integrand);
+        free(data);
+        return nullptr;
+    }
+    
+    memcpy(data, c, dims * sizeof(double));
+    integrand->kind = INTEGRAND_GENZ_OSCILLATORY;
+    integrand->count = dims;
+    integrand->data = data;
+    integrand->params[0] = u;
+    
+    return integrand;
+}
+
+// Free an integrand created by integrand_create_*
+EMSCRIPTEN_KEEPALIVE
+void integrand_destroy(Integrand* integrand) {
+    if (integrand) {
+        free(integrand->data);
+        free(integrand);
+    }
+}
+
+// Trapezoidal rule over any integrand (nullptr integrates the test function)
+EMSCRIPTEN_KEEPALIVE
+double integrate_trapezoidal(const Integrand* integrand, double a, double b, int n) {
+    if (n <= 0) return 0.0;
+    
+    return dispatch_integrand(integrand, [&](const auto& f) { return trapezoid_rule(f, a, b, n); });
+}
+
+// Simpson's rule over any integrand (nullptr integrates the test function)
+EMSCRIPTEN_KEEPALIVE
+double integrate_simpson(const Integrand* integrand, double a, double b, int n) {
     if (n <= 0 || n % 2 != 0) return 0.0; // n must be even for Simpson's rule
     
-    double h = (b - a) / n;
-    double sum = test_function(a) + test_function(b);
+    return dispatch_integrand(integrand, [&](const auto& f) { return simpson_rule(f, a, b, n); });
+}
+
+// Gauss-Legendre rule of the given order (1..64) over any integrand
+EMSCRIPTEN_KEEPALIVE
+double integrate_gauss_legendre(const Integrand* integrand, double a, double b, int order) {
+    const GaussLegendreRule* rule = get_gauss_legendre_rule(order);
+    if (!rule) return 0.0;
     
-    // Add odd-indexed terms (coefficient 4)
-    for (int i = 1; i < n; i += 2) {
-        double x = a + i * h;
-        sum += 4.0 * test_function(x);
+    return dispatch_integrand(integrand, [&](const auto& f) { return gauss_legendre_rule(f, rule, a, b); });
+}
+
+// Romberg integration with 2^levels intervals at the finest level (levels 0..30)
+EMSCRIPTEN_KEEPALIVE
+double integrate_romberg(const Integrand* integrand, double a, double b, int levels) {
+    if (levels < 0 || levels > ROMBERG_MAX_LEVELS) return 0.0;
+    
+    return dispatch_integrand(integrand, [&](const auto& f) { return romberg_rule(f, a, b, levels); });
+}
+
+// Trapezoidal rule over any integrand, reduced on up to `threads` threads
+// (<= 0 uses every pool thread). summation selects SUMMATION_NAIVE,
+// SUMMATION_COMPENSATED or SUMMATION_PAIRWISE. Results are bit-reproducible
+// for a fixed thread count.
+EMSCRIPTEN_KEEPALIVE
+double integrate_trapezoidal_parallel(const Integrand* integrand, double a, double b, int n,
+                                      int threads, int summation) {
+    if (n <= 0) return 0.0;
+    
+    if (threads <= 0) threads = ThreadPool::instance().max_threads();
+    if (threads > THREAD_POOL_MAX_THREADS) threads = THREAD_POOL_MAX_THREADS;
+    
+    double* partials = (double*)malloc(threads * 4 * sizeof(double));
+    double result = dispatch_integrand(integrand, [&](const auto& f) {
+        return trapezoid_rule_parallel(f, a, b, n, threads, summation, partials);
+    });
+    free(partials);
+    
+    return result;
+}
+
+// Adaptive Gauss-Kronrod (G7-K15) integration of an integrand over [a, b]
+// (nullptr integrates the test function). Stops once the estimated error is below
+// max(abs_tol, rel_tol * |value|) or max_evals would be exceeded.
+// Returns [value, error_estimate, evaluations]; free with free_integration_data.
+EMSCRIPTEN_KEEPALIVE
+double* integrate_adaptive(const Integrand* integrand, double a, double b,
+                           double abs_tol, double rel_tol, int max_evals) {
+    if (max_evals < 15) return nullptr;
+    
+    double* results = (double*)malloc(3 * sizeof(double));
+    if (!results) return nullptr;
+    
+    dispatch_integrand(integrand, [&](const auto& f) {
+        integrate_adaptive_kernel(f, a, b, abs_tol, rel_tol, max_evals, results);
+        return 0.0;
+    });
+    
+    return results;
+}
+
+// Monte Carlo / quasi-Monte Carlo integration of a Genz integrand over the box
+// [lower, upper] (nullptr bounds mean the unit cube).
+// The error is estimated from `replicates` independent randomizations (separate
+// PRNG streams, or separately shifted Halton/Sobol point sets). Each round
+// doubles the points per replicate, starting from block_size, and integration
+// stops once the standard error is below max(abs_tol, rel_tol * |estimate|) or
+// max_evals would be exceeded. Work is split into fixed chunks on up to
+// `threads` threads (<= 0 uses every pool thread); every chunk has its own
+// point range, so results are identical for any thread count.
+// Returns nullptr if replicates * block_size (rounded up to whole chunks) exceeds max_evals.
+// Returns [estimate, standard_error, evaluations, converged]; free with free_integration_data.
+EMSCRIPTEN_KEEPALIVE
+double* integrate_monte_carlo(const Integrand* integrand, const double* lower, const double* upper,
+                              int sampler, int replicates, int block_size, int max_evals,
+                              double abs_tol, double rel_tol, unsigned int seed, int threads) {
+    if (!integrand || (integrand->kind != INTEGRAND_GENZ_GAUSSIAN && integrand->kind != INTEGRAND_GENZ_OSCILLATORY)) {
+        return nullptr;
     }
+    if (replicates < 2 || replicates > MC_MAX_REPLICATES || block_size <= 0) return nullptr;
     
-    // Add even-indexed terms (coefficient 2)
-    for (int i = 2; i < n; i += 2) {
-        double x = a + i * h;
-        sum += 2.0 * test_function(x);
+    int dims = integrand->count;
+    block_size = (block_size + MC_CHUNK - 1) / MC_CHUNK * MC_CHUNK;
+    // The first round must fit in the evaluation budget
+    if ((double)block_size * replicates > (double)max_evals) return nullptr;
+    
+    MonteCarloSampler* ms = (MonteCarloSampler*)malloc(sizeof(MonteCarloSampler));
+    double* results = (double*)malloc(4 * sizeof(double));
+    if (!ms || !results) {
+        free(ms);
+        free(results);
+        return nullptr;
     }
     
-    return sum * h / 3.0;
+    ms->sampler = sampler;
+    ms->dims = dims;
+    double volume = 1.0;
+    for (int k = 0; k < dims; k++) {
+        ms->lower[k] = lower ? lower[k] : 0.0;
+        ms->width[k] = upper ? upper[k] - ms->lower[k] : 1.0 - ms->lower[k];
+        volume *= ms->width[k];
+    }
+    for (int r = 0; r < replicates; r++) {
+        ms->keys[r] = mix64(((uint64_t)seed << 32) + r + 1);
+        for (int k = 0; k < dims; k++) {
+            uint64_t bits = counter_random(ms->keys[r] ^ 0xD1B54A32D192ED03ULL, k);
+            ms->shifts[r][k] = (double)(bits >> 11) * (1.0 / 9007199254740992.0);
+            ms->digital_shifts[r][k] = (uint32_t)(bits >> 32);
+        }
+    }
+    if (sampler == MC_SAMPLER_SOBOL) init_sobol_directions();
+    
+    if (threads <= 0) threads = ThreadPool::instance().max_threads();
+    if (threads > THREAD_POOL_MAX_THREADS) threads = THREAD_POOL_MAX_THREADS;
+    
+    // Per-worker point and value buffers, per-replicate running sums
+    double* scratch = (double*)malloc((size_t)threads * (dims + 1) * MC_CHUNK * sizeof(double));
+    double* replicate_sums = (double*)calloc(replicates, sizeof(double));
+    std::vector<double> partials;
+    if (!scratch || !replicate_sums) {
+        free(ms);
+        free(results);
+        free(scratch);
+        free(replicate_sums);
+        return nullptr;
+    }
+    
+    long long points_per_replicate = 0;
+    long long round_points = block_size;
+    double estimate = 0.0;
+    double std_error = 0.0;
+    bool converged = false;
+    
+    while ((double)(points_per_replicate + round_points) * replicates <= (double)max_evals &&
+           points_per_replicate + round_points <= 0x7FFFFFFF) {
+        int chunks_per_replicate = (int)(round_points / MC_CHUNK);
+        int num_tasks = chunks_per_replicate * replicates;
+        partials.assign(num_tasks, 0.0);
+        uint32_t round_start = (uint32_t)points_per_replicate;
+        
+        dispatch_multi_integrand(integrand, [&](const auto& f) {
+            parallel_for(num_tasks, threads, [&](int task, int worker) {
+                int replicate = task / chunks_per_replicate;
+                int chunk = task % chunks_per_replicate;
+                double* points = scratch + (size_t)worker * (dims + 1) * MC_CHUNK;
+                double* values = points + (size_t)dims * MC_CHUNK;
+                
+                generate_points(*ms, replicate, round_start + chunk * MC_CHUNK, MC_CHUNK, points);
+                f(points, MC_CHUNK, values);
+                
+                double sum0 = 0.0, sum1 = 0.0;
+                for (int j = 0; j < MC_CHUNK; j += 2) {
+                    sum0 += values[j];
+                    sum1 += values[j + 1];
+                }
+                partials[task] = sum0 + sum1;
+            });
+        });
+        
+        // Fold the chunks into the replicates in a fixed order
+        for (int task = 0; task < num_tasks; task++) {
+            replicate_sums[task / chunks_per_replicate] += partials[task];
+        }
+        points_per_replicate += round_points;
+        round_points = points_per_replicate;
+        
+        // Mean and standard error over the replicate estimates
+        double mean = 0.0;
+        for (int r = 0; r < replicates; r++) {
+            mean += replicate_sums[r];
+        }
+        mean = mean / replicates / points_per_replicate;
+        double variance = 0.0;
+        for (int r = 0; r < replicates; r++) {
+            double deviation = replicate_sums[r] / points_per_replicate - mean;
+            variance += deviation * deviation;
+        }
+        variance /= (replicates - 1);
+        
+        estimate = mean * volume;
+        std_error = sqrt(variance / replicates) * fabs(volume);
+        if (std_error <= std::max(abs_tol, rel_tol * fabs(estimate))) {
+            converged = true;
+            break;
+        }
+    }
+    
+    results[0] = estimate;
+    results[1] = std_error;
+    results[2] = (double)(points_per_replicate * replicates);
+    results[3] = converged ? 1.0 : 0.0;
+    
+    free(ms);
+    free(scratch);
+    free(replicate_sums);
+    
+    return results;
 }
 
 // Get the analytical solution for comparison
@@ -121,17 +1272,28 @@ double* run_integration_test(int n) {
     // Analytical solution
     double analytical_result = analytical_solution(a, b);
     
-    // Compute errors
-    double trapezoidal_error = fabs(trapezoidal_result - analytical_result);
+    // Gauss-Legendre with up to n nodes, and Romberg with at most n intervals
+    int order = n < GAUSS_LEGENDRE_MAX_ORDER ? n : GAUSS_LEGENDRE_MAX_ORDER;
+    double gauss_legendre_result = integrate_gauss_legendre(nullptr, a, b, order);
     
-    // Allocate memory for results: [trapezoidal, simpson, analytical, trapezoidal_error]
-    double* results = (double*)malloc(4 * sizeof(double));
+    int levels = 0;
+    while (levels < ROMBERG_MAX_LEVELS && (2 << levels) <= n) levels++;
+    double romberg_result = integrate_romberg(nullptr, a, b, levels);
+    
+    // Allocate memory for results: [trapezoidal, simpson, analytical, trapezoidal_error,
+    // simpson_error, gauss_legendre, gauss_legendre_error, romberg, romberg_error]
+    double* results = (double*)malloc(9 * sizeof(double));
     if (!results) return nullptr;
     
     results[0] = trapezoidal_result;
     results[1] = simpson_result;
     results[2] = analytical_result;
-    results[3] = trapezoidal_error;
+    results[3] = fabs(trapezoidal_result - analytical_result);
+    results[4] = fabs(simpson_result - analytical_result);
+    results[5] = gauss_legendre_result;
+    results[6] = fabs(gauss_legendre_result - analytical_result);
+    results[7] = romberg_result;
+    results[8] = fabs(romberg_result - analytical_result);
     
     return results;
 }
@@ -0,0 +1,178 @@
+#ifndef WASM_BENCHMARK_THREAD_POOL_H
+#define WASM_BENCHMARK_THREAD_POOL_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+// Upper bound on pool size; scripts/build.sh sets PTHREAD_POOL_SIZE to match
+#ifndef THREAD_POOL_MAX_THREADS
+#define THREAD_POOL_MAX_THREADS 16
+#endif
+
+// Persistent worker pool shared by the math kernels.
+// Workers are created once per module instance, on first use, and then parked
+// on a condition variable between jobs. Without -pthread the pool has a single
+// thread and every job runs on the caller.
+class ThreadPool {
+public:
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Number of threads available to a job, including the calling thread
+    int max_threads() const {
+#ifdef __EMSCRIPTEN_PTHREADS__
+        return (int)workers_.size() + 1;
+#else
+        return 1;
+#endif
+    }
+
+    // Run fn(worker, num_workers) on num_workers threads and wait for all of them.
+    // The caller acts as worker 0. Calls made from inside a job run serially.
+    void run(int num_workers, const std::function<void(int, int)>& fn) {
+        if (num_workers > max_threads()) num_workers = max_threads();
+#ifdef __EMSCRIPTEN_PTHREADS__
+        if (num_workers <= 1 || inside_job()) {
+            fn(0, 1);
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            job_workers_ = num_workers;
+            pending_ = num_workers - 1;
+            generation_++;
+        }
+        start_cv_.notify_all();
+
+        inside_job() = true;
+        fn(0, num_workers);
+        inside_job() = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+#else
+        (void)num_workers;
+        fn(0, 1);
+#endif
+    }
+
+private:
+#ifdef __EMSCRIPTEN_PTHREADS__
+    ThreadPool() {
+        int count = (int)std::thread::hardware_concurrency();
+        if (count < 1) count = 1;
+        if (count > THREAD_POOL_MAX_THREADS) count = THREAD_POOL_MAX_THREADS;
+
+        for (int i = 1; i < count; i++) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    static bool& inside_job() {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    void worker_loop(int index) {
+        inside_job() = true;
+        unsigned long seen = 0;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            if (index >= job_workers_) continue;
+
+            const std::function<void(int, int)>* job = job_;
+            int count = job_workers_;
+            lock.unlock();
+            (*job)(index, count);
+            lock.lock();
+
+            if (--pending_ == 0) done_cv_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(int, int)>* job_ = nullptr;
+    int job_workers_ = 0;
+    int pending_ = 0;
+    unsigned long generation_ = 0;
+    bool stop_ = false;
+#else
+    ThreadPool() {}
+#endif
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+// Run fn(task, worker) for every task in [0, num_tasks) on up to num_workers threads.
+// Each worker starts on its own contiguous range of tasks and, once that range is
+// drained, steals remaining tasks from the other workers' ranges.
+inline void parallel_for(int num_tasks, int num_workers, const std::function<void(int, int)>& fn) {
+    if (num_tasks <= 0) return;
+
+    ThreadPool& pool = ThreadPool::instance();
+    if (num_workers > pool.max_threads()) num_workers = pool.max_threads();
+    if (num_workers > num_tasks) num_workers = num_tasks;
+    if (num_workers <= 1) {
+        for (int task = 0; task < num_tasks; task++) {
+            fn(task, 0);
+        }
+        return;
+    }
+
+    struct alignas(64) TaskRange {
+        std::atomic<int> next;
+        int end;
+    };
+    std::unique_ptr<TaskRange[]> ranges(new TaskRange[num_workers]);
+    for (int w = 0; w < num_workers; w++) {
+        ranges[w].next.store((int)((long long)num_tasks * w / num_workers));
+        ranges[w].end = (int)((long long)num_tasks * (w + 1) / num_workers);
+    }
+
+    pool.run(num_workers, [&](int worker, int) {
+        for (int offset = 0; offset < num_workers; offset++) {
+            TaskRange& range = ranges[(worker + offset) % num_workers];
+            for (;;) {
+                int task = range.next.fetch_add(1);
+                if (task >= range.end) break;
+                fn(task, worker);
+            }
+        }
+    });
+}
+
+#endif // WASM_BENCHMARK_THREAD_POOL_H
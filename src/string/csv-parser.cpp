@@ -5,6 +5,9 @@
 #include <cstring>
 #include <cmath>
 #include <chrono>
+#include <cstdint>
+
+#include "number-parser.h"
 
 extern "C" {
 
@@ -68,33 +71,71 @@ void generate_csv_data_internal(int num_records, char* buffer, size_t buffer_siz
     }
 }
 
-// Process a parsed CSV field and store it in the record
-void process_csv_field(const char* field, int field_index, CsvRecord* record) {
+// Numeric fields read in place; like atoi/atof, leading blanks are skipped and a
+// field without a number reads as 0
+static inline int csv_int(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+    int64_t value;
+    return parse_int64(begin, end, &value) ? (int)value : 0;
+}
+
+static inline double csv_double(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+    double value;
+    return parse_double(begin, end, &value) ? value : 0.0;
+}
+
+// Copy a text field into a record member of the given size, truncating it
+static inline void csv_text(char* dest, size_t size, const char* begin, const char* end) {
+    size_t length = end - begin;
+    if (length > size - 1) length = size - 1;
+    memcpy(dest, begin, length);
+    dest[length] = '\0';
+}
+
+// Process the parsed CSV field [begin, end) and store it in the record
+void process_csv_field(const char* begin, const char* end, int field_index, CsvRecord* record) {
     switch (field_index) {
-        case 0: record->id = atoi(field); break;
-        case 1: strncpy(record->name, field, 31); record->name[31] = '\0'; break;
-        case 2: record->value1 = atof(field); break;
-        case 3: record->value2 = atof(field); break;
-        case 4: record->value3 = atof(field); break;
-        case 5: record->category = atoi(field); break;
-        case 6: strncpy(record->status, field, 15); record->status[15] = '\0'; break;
-        case 7: record->price = atof(field); break;
-        case 8: record->quantity = atoi(field); break;
-        case 9: strncpy(record->date, field, 11); record->date[11] = '\0'; break;
-        case 10: record->score1 = atof(field); break;
-        case 11: record->score2 = atof(field); break;
-        case 12: record->score3 = atof(field); break;
-        case 13: record->priority = atoi(field); break;
-        case 14: strncpy(record->description, field, 63); record->description[63] = '\0'; break;
-        case 15: record->weight = atof(field); break;
-        case 16: record->count = atoi(field); break;
-        case 17: strncpy(record->type, field, 15); record->type[15] = '\0'; break;
-        case 18: record->ratio = atof(field); break;
-        case 19: record->flag = atoi(field); break;
+        case 0: record->id = csv_int(begin, end); break;
+        case 1: csv_text(record->name, sizeof(record->name), begin, end); break;
+        case 2: record->value1 = csv_double(begin, end); break;
+        case 3: record->value2 = csv_double(begin, end); break;
+        case 4: record->value3 = csv_double(begin, end); break;
+        case 5: record->category = csv_int(begin, end); break;
+        case 6: csv_text(record->status, sizeof(record->status), begin, end); break;
+        case 7: record->price = csv_double(begin, end); break;
+        case 8: record->quantity = csv_int(begin, end); break;
+        case 9: csv_text(record->date, sizeof(record->date), begin, end); break;
+        case 10: record->score1 = csv_double(begin, end); break;
+        case 11: record->score2 = csv_double(begin, end); break;
+        case 12: record->score3 = csv_double(begin, end); break;
+        case 13: record->priority = csv_int(begin, end); break;
+        case 14: csv_text(record->description, sizeof(record->description), begin, end); break;
+        case 15: record->weight = csv_double(begin, end); break;
+        case 16: record->count = csv_int(begin, end); break;
+        case 17: csv_text(record->type, sizeof(record->type), begin, end); break;
+        case 18: record->ratio = csv_double(begin, end); break;
+        case 19: record->flag = csv_int(begin, end); break;
+    }
+}
+
+// Process the field [begin, end). Unquoted fields are read in place; quoted ones are
+// copied into buffer without their quote characters first.
+static inline void process_csv_span(const char* begin, const char* end, bool quoted, int field_index,
+                                    CsvRecord* record, char* buffer, size_t buffer_size) {
+    if (!quoted) {
+        process_csv_field(begin, end, field_index, record);
+        return;
+    }
+    
+    size_t length = 0;
+    for (const char* c = begin; c < end && length < buffer_size; c++) {
+        if (*c != '"') buffer[length++] = *c;
     }
+    process_csv_field(buffer, buffer + length, field_index, record);
 }
 
-// Optimized CSV parser using direct buffer access
+// Optimized CSV parser: fields are processed in place as [begin, end) spans
 int parse_csv_string_optimized(const char* csv_str, CsvRecord* records, int max_records) {
     const char* ptr = csv_str;
     const char* end = csv_str + strlen(csv_str);
@@ -103,9 +144,10 @@ int parse_csv_string_optimized(const char* csv_str, CsvRecord* records, int max_
     
     CsvRecord current_record = {0};
     char field_buffer[256];
-    int field_pos = 0;
+    const char* field_start = ptr;
     int field_index = 0;
     bool in_quotes = false;
+    bool quoted = false;
     
     while (ptr < end && record_count < max_records) {
         char c = *ptr;
@@ -113,21 +155,18 @@ int parse_csv_string_optimized(const char* csv_str, CsvRecord* records, int max_
         // Handle quotes (for fields that might contain commas)
         if (c == '"') {
             in_quotes = !in_quotes;
+            quoted = true;
             ptr++;
             continue;
         }
         
         // Handle field separators and line endings
         if ((c == ',' && !in_quotes) || c == '\n' || c == '\r') {
-            // Null-terminate current field
-            field_buffer[field_pos] = '\0';
-            
             // Process field if we're not skipping header
             if (!skip_header && field_index < 20) {
-                process_csv_field(field_buffer, field_index, &current_record);
+                process_csv_span(field_start, ptr, quoted, field_index, &current_record, field_buffer, sizeof(field_buffer));
             }
             
-            field_pos = 0;
             field_index++;
             
             // Handle end of line
@@ -147,22 +186,20 @@ int parse_csv_string_optimized(const char* csv_str, CsvRecord* records, int max_
             }
             
             ptr++;
+            field_start = ptr;
+            quoted = false;
             continue;
         }
         
-        // Add character to current field
-        if (field_pos < 255) {
-            field_buffer[field_pos++] = c;
-        }
-        
         ptr++;
     }
     
     // Handle last record if file doesn't end with newline
-    if (!skip_header && field_index >= 20 && current_record.id > 0) {
-        field_buffer[field_pos] = '\0';
-        process_csv_field(field_buffer, field_index, &current_record);
-        records[record_count++] = current_record;
+    if (!skip_header && field_index >= 19 && record_count < max_records) {
+        process_csv_span(field_start, ptr, quoted, field_index, &current_record, field_buffer, sizeof(field_buffer));
+        if (current_record.id > 0) {
+            records[record_count++] = current_record;
+        }
     }
     
     return record_count;
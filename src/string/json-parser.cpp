@@ -5,6 +5,884 @@
 #include <cstring>
 #include <cmath>
 #include <chrono>
+#include <cstdint>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "number-parser.h"
+
+// Stage 1 of the parser: a structural index of the input.
+// The input is scanned in 64-byte blocks. Each block is reduced to 64-bit masks
+// (quotes, backslashes, structural operators, whitespace), string interiors are
+// found with bit arithmetic, and the positions of every structural operator
+// outside strings, every unescaped quote and every scalar start are recorded.
+// Stage 2 then only visits those positions.
+#define JSON_BLOCK_SIZE 64
+
+// Stage 1 runs ahead of stage 2 by this many blocks (32 KB of input), so the
+// index stays in cache and parsing can stop early without scanning the rest
+#define JSON_WINDOW_BLOCKS 512
+
+// Positions found by stage 1 that stage 2 has not consumed yet
+struct StructuralIndex {
+    uint32_t positions[JSON_WINDOW_BLOCKS * JSON_BLOCK_SIZE + 8];
+    size_t count;
+};
+
+// Stage 1 state carried from one block to the next
+struct StructuralScanner {
+    const char* json;
+    const char* base;        // json rounded down to 16 bytes
+    size_t block_start;      // offset of the next block from base
+    int skip;                // bytes of the first block before json
+    uint64_t prev_escaped;   // next block starts with an escaped character
+    uint64_t prev_in_string; // all ones when the previous block ended inside a string
+    uint64_t prev_scalar;    // previous block ended inside a scalar
+    bool done;
+    size_t length;           // input length, known once done
+};
+
+// Per-block character classes, one bit per byte
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;          // { } [ ] : ,
+    uint64_t whitespace;
+    uint64_t valid;       // bytes that belong to the input
+    int end;              // offset of the terminating NUL, or JSON_BLOCK_SIZE
+};
+
+#ifndef __wasm_simd128__
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_LOW7 0x7F7F7F7F7F7F7F7FULL
+
+// High bit of every byte of word equal to c
+static inline uint64_t swar_byte_eq(uint64_t word, unsigned char c) {
+    uint64_t x = word ^ (SWAR_ONES * c);
+    return ~(((x & SWAR_LOW7) + SWAR_LOW7) | x | SWAR_LOW7);
+}
+
+// Gather the high bits of the 8 bytes into an 8-bit mask, byte 0 in bit 0
+static inline uint64_t swar_movemask(uint64_t high_bits) {
+    return ((high_bits >> 7) * 0x0102040810204080ULL) >> 56;
+}
+#endif
+
+// Classify the 64 bytes at block. Bytes before skip and from the first NUL on are
+// not part of the input; returns true when the NUL was found in this block.
+// Both paths read whole aligned 16-byte chunks: the caller keeps block 16-byte
+// aligned, so no read crosses into a page beyond the chunk holding the NUL.
+static bool classify_block(const char* block, int skip, BlockMasks* masks) {
+    uint64_t quote = 0, backslash = 0, op = 0, whitespace = 0;
+    int length = JSON_BLOCK_SIZE;
+    bool at_end = false;
+    
+#ifdef __wasm_simd128__
+    for (int chunk = 0; chunk < 4; chunk++) {
+        v128_t bytes = wasm_v128_load(block + 16 * chunk);
+        // '[' and ']' differ from '{' and '}' only in bit 5
+        v128_t folded = wasm_v128_or(bytes, wasm_i8x16_splat(0x20));
+        v128_t is_op = wasm_v128_or(
+            wasm_v128_or(wasm_i8x16_eq(folded, wasm_i8x16_splat('{')), wasm_i8x16_eq(folded, wasm_i8x16_splat('}'))),
+            wasm_v128_or(wasm_i8x16_eq(bytes, wasm_i8x16_splat(':')), wasm_i8x16_eq(bytes, wasm_i8x16_splat(','))));
+        v128_t is_space = wasm_v128_or(
+            wasm_v128_or(wasm_i8x16_eq(bytes, wasm_i8x16_splat(' ')), wasm_i8x16_eq(bytes, wasm_i8x16_splat('\n'))),
+            wasm_v128_or(wasm_i8x16_eq(bytes, wasm_i8x16_splat('\t')), wasm_i8x16_eq(bytes, wasm_i8x16_splat('\r'))));
+        
+        int shift = 16 * chunk;
+        quote |= (uint64_t)wasm_i8x16_bitmask(wasm_i8x16_eq(bytes, wasm_i8x16_splat('"'))) << shift;
+        backslash |= (uint64_t)wasm_i8x16_bitmask(wasm_i8x16_eq(bytes, wasm_i8x16_splat('\\'))) << shift;
+        op |= (uint64_t)wasm_i8x16_bitmask(is_op) << shift;
+        whitespace |= (uint64_t)wasm_i8x16_bitmask(is_space) << shift;
+        
+        uint32_t nul = wasm_i8x16_bitmask(wasm_i8x16_eq(bytes, wasm_i8x16_splat(0))) >> (chunk == 0 ? skip : 0);
+        if (nul) {
+            length = shift + (chunk == 0 ? skip : 0) + __builtin_ctz(nul);
+            at_end = true;
+            break;
+        }
+    }
+#else
+    // SWAR fallback: the same classification on 8 bytes at a time
+    for (int word = 0; word < 8; word++) {
+        uint64_t bytes;
+        memcpy(&bytes, block + 8 * word, 8);
+        uint64_t folded = bytes | (SWAR_ONES * 0x20);
+        uint64_t is_op = swar_byte_eq(folded, '{') | swar_byte_eq(folded, '}') |
+                         swar_byte_eq(bytes, ':') | swar_byte_eq(bytes, ',');
+        uint64_t is_space = swar_byte_eq(bytes, ' ') | swar_byte_eq(bytes, '\n') |
+                            swar_byte_eq(bytes, '\t') | swar_byte_eq(bytes, '\r');
+        
+        int shift = 8 * word;
+        quote |= swar_movemask(swar_byte_eq(bytes, '"')) << shift;
+        backslash |= swar_movemask(swar_byte_eq(bytes, '\\')) << shift;
+        op |= swar_movemask(is_op) << shift;
+        whitespace |= swar_movemask(is_space) << shift;
+        
+        uint64_t nul = (swar_movemask(swar_byte_eq(bytes, 0)) << shift) & (~0ULL << skip);
+        if (nul) {
+            length = __builtin_ctzll(nul);
+            at_end = true;
+            break;
+        }
+    }
+#endif
+    
+    uint64_t valid = (length == 64 ? ~0ULL : (1ULL << length) - 1) & (~0ULL << skip);
+    masks->quote = quote & valid;
+    masks->backslash = backslash & valid;
+    masks->op = op & valid;
+    masks->whitespace = whitespace & valid;
+    masks->valid = valid;
+    masks->end = length;
+    return at_end;
+}
+
+// Bits of characters escaped by a backslash, for runs of backslashes of any length.
+// *prev_escaped carries an escape across the block boundary.
+static inline uint64_t find_escaped(uint64_t backslash, uint64_t* prev_escaped) {
+    const uint64_t even_bits = 0x5555555555555555ULL;
+    
+    backslash &= ~*prev_escaped;
+    uint64_t follows_escape = (backslash << 1) | *prev_escaped;
+    
+    // Adding the odd-position run starts to the backslashes carries through each run;
+    // the carry out of bit 63 is an escape for the next block
+    uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+    *prev_escaped = sequences_starting_on_even_bits < odd_sequence_starts ? 1 : 0;
+    uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+    
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// Running XOR of the bits below and including each position
+static inline uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+static void scanner_init(StructuralScanner* scanner, const char* json) {
+    scanner->json = json;
+    // Read whole 16-byte aligned chunks, starting at or before json
+    scanner->base = (const char*)((uintptr_t)json & ~(uintptr_t)15);
+    scanner->block_start = 0;
+    scanner->skip = (int)(json - scanner->base);
+    scanner->prev_escaped = 0;
+    scanner->prev_in_string = 0;
+    scanner->prev_scalar = 0;
+    scanner->done = false;
+    scanner->length = 0;
+}
+
+// Scan up to JSON_WINDOW_BLOCKS blocks and append their structural positions
+// (offsets from json) to index. Sets scanner->done at the terminating NUL.
+static void scanner_next_window(StructuralScanner* scanner, StructuralIndex* index) {
+    for (int block = 0; block < JSON_WINDOW_BLOCKS && !scanner->done; block++) {
+        BlockMasks masks;
+        bool at_end = classify_block(scanner->base + scanner->block_start, scanner->skip, &masks);
+        
+        uint64_t escaped = find_escaped(masks.backslash, &scanner->prev_escaped);
+        uint64_t quote = masks.quote & ~escaped;
+        // Set from each opening quote up to (not including) its closing quote
+        uint64_t in_string = prefix_xor(quote) ^ scanner->prev_in_string;
+        scanner->prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+        
+        // Scalars (numbers, true, false, null) start where a run of other bytes begins
+        uint64_t scalar = masks.valid & ~(masks.op | masks.whitespace | quote | in_string);
+        uint64_t scalar_start = scalar & ~((scalar << 1) | scanner->prev_scalar);
+        scanner->prev_scalar = scalar >> 63;
+        
+        uint64_t structurals = (masks.op & ~in_string) | quote | scalar_start;
+        
+        uint32_t offset = (uint32_t)(scanner->block_start - (scanner->json - scanner->base));
+        uint32_t* out = index->positions + index->count;
+        while (structurals) {
+            *out++ = offset + __builtin_ctzll(structurals);
+            structurals &= structurals - 1;
+        }
+        index->count = out - index->positions;
+        
+        if (at_end) {
+            scanner->length = offset + masks.end;
+            scanner->done = true;
+        }
+        scanner->block_start += JSON_BLOCK_SIZE;
+        scanner->skip = 0;
+    }
+}
+
+// Document object model: a tape of tagged 64-bit words built from the structural
+// index, one entry per value in document order. Each word holds a type tag in its
+// top byte and a 56-bit payload:
+//   'r'          root; the first word points past the last one, the last one back to 0
+//   '{' '['      (element count << 32) | index just past the matching close word
+//   '}' ']'      index of the matching open word
+//   '"'          offset of the string in the input, followed by a word with its length.
+//                Strings with escapes are unescaped onto the tape right after the
+//                length word instead, and flagged with JSON_TAPE_INLINE
+//   'l' 'd'      int64 or double, stored in the following word
+//   't' 'f' 'n'  true, false, null
+#define JSON_TAPE_TAG(tag) ((uint64_t)(unsigned char)(tag) << 56)
+#define JSON_TAPE_PAYLOAD_MASK ((1ULL << 56) - 1)
+#define JSON_TAPE_INLINE (1ULL << 55)
+#define JSON_TAPE_COUNT_MAX 0xFFFFFF
+#define JSON_MAX_DEPTH 1024
+
+// Errors returned by json_document_parse
+#define JSON_ERROR_MEMORY -1
+#define JSON_ERROR_SYNTAX -2
+#define JSON_ERROR_DEPTH -3
+
+// What the tape builder expects at the next structural position
+enum TapeState { TAPE_VALUE, TAPE_FIRST_VALUE, TAPE_KEY, TAPE_FIRST_KEY, TAPE_COLON, TAPE_AFTER_VALUE, TAPE_DONE };
+
+// Bump-pointer arena holding the tape. It is reset, not freed, between documents,
+// so releasing a document is O(1) and parsing does no per-node allocation.
+// Growing may move base, so everything in it is referenced by offset.
+struct JsonArena {
+    char* base;
+    size_t used;
+    size_t capacity;
+};
+
+static bool arena_reserve(JsonArena* arena, size_t bytes) {
+    if (arena->used + bytes <= arena->capacity) return true;
+    
+    size_t new_capacity = arena->capacity ? arena->capacity : 4096;
+    while (new_capacity < arena->used + bytes) new_capacity *= 2;
+    char* grown = (char*)realloc(arena->base, new_capacity);
+    if (!grown) return false;
+    arena->base = grown;
+    arena->capacity = new_capacity;
+    return true;
+}
+
+struct JsonDocument {
+    JsonArena arena;
+    const char* json;        // input; string entries point into it
+    size_t json_length;
+    size_t tape_length;      // words on the tape, 0 until a parse succeeds
+    StructuralIndex* index;
+    // Tape builder state, carried across index windows
+    TapeState state;
+    int depth;
+    uint32_t open[JSON_MAX_DEPTH];    // tape index of each open container
+    uint32_t counts[JSON_MAX_DEPTH];  // elements seen in each open container
+};
+
+// Characters that may follow a number or a literal
+static inline bool is_json_terminator(char c) {
+    switch (c) {
+        case '\0': case ' ': case '\t': case '\n': case '\r':
+        case ',': case ':': case ']': case '}':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Parse the JSON number at p, which ends before end. Integers that fit are returned
+// exactly in *integer; everything else is a double. Returns false if p is not a
+// number in JSON's stricter grammar (no '+', no leading zeros, digits around '.').
+static bool parse_json_number(const char* p, const char* end, bool* is_integer, int64_t* integer, double* real) {
+    const char* digits = p + (*p == '-');
+    if (!is_decimal_digit(*digits) || (digits[0] == '0' && is_decimal_digit(digits[1]))) return false;
+    
+    const char* number_end = parse_int64(p, end, integer);
+    if (number_end && is_json_terminator(*number_end)) {
+        *is_integer = true;
+        return true;
+    }
+    
+    number_end = parse_double(p, end, real);
+    if (!number_end || !is_json_terminator(*number_end)) return false;
+    const char* dot = (const char*)memchr(p, '.', number_end - p);
+    if (dot && !is_decimal_digit(dot[1])) return false;
+    
+    *is_integer = false;
+    return true;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Value of the four hex digits of a \u escape at p, or -1
+static long parse_unicode_escape(const char* p, const char* end) {
+    if (end - p < 4) return -1;
+    long code = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hex_value(p[i]);
+        if (digit < 0) return -1;
+        code = code * 16 + digit;
+    }
+    return code;
+}
+
+// Unescape the string body [begin, end) into out as UTF-8. The output is never
+// longer than the input. Returns the output length, or -1 for an invalid escape.
+static long unescape_json_string(const char* begin, const char* end, char* out) {
+    char* o = out;
+    for (const char* c = begin; c < end; c++) {
+        if (*c != '\\') {
+            *o++ = *c;
+            continue;
+        }
+        
+        // Stage 1 only ends a string at an unescaped quote, so a backslash is never last
+        c++;
+        switch (*c) {
+            case '"': case '\\': case '/': *o++ = *c; break;
+            case 'b': *o++ = '\b'; break;
+            case 'f': *o++ = '\f'; break;
+            case 'n': *o++ = '\n'; break;
+            case 'r': *o++ = '\r'; break;
+            case 't': *o++ = '\t'; break;
+            case 'u': {
+                long code = parse_unicode_escape(c + 1, end);
+                if (code < 0) return -1;
+                c += 4;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // High surrogate; a low one must follow
+                    if (end - c < 7 || c[1] != '\\' || c[2] != 'u') return -1;
+                    long low = parse_unicode_escape(c + 3, end);
+                    if (low < 0xDC00 || low > 0xDFFF) return -1;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    c += 6;
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    return -1;
+                }
+                
+                if (code < 0x80) {
+                    *o++ = (char)code;
+                } else if (code < 0x800) {
+                    *o++ = (char)(0xC0 | (code >> 6));
+                    *o++ = (char)(0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    *o++ = (char)(0xE0 | (code >> 12));
+                    *o++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *o++ = (char)(0x80 | (code & 0x3F));
+                } else {
+                    *o++ = (char)(0xF0 | (code >> 18));
+                    *o++ = (char)(0x80 | ((code >> 12) & 0x3F));
+                    *o++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *o++ = (char)(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+    return o - out;
+}
+
+// Append the string between the quotes at open and close. Strings without escapes
+// are zero-copy views of the input. spare_words is the room the rest of the window
+// needs, kept when the arena has to grow for an inline string.
+static int tape_append_string(JsonDocument* doc, size_t* length, const char* open, const char* close, size_t spare_words) {
+    size_t size = close - open - 1;
+    
+    if (!memchr(open + 1, '\\', size)) {
+        uint64_t* tape = (uint64_t*)doc->arena.base;
+        tape[(*length)++] = JSON_TAPE_TAG('"') | (uint64_t)(open + 1 - doc->json);
+        tape[(*length)++] = size;
+        return 0;
+    }
+    
+    size_t words = (size + 7) / 8;
+    doc->arena.used = *length * sizeof(uint64_t);
+    if (!arena_reserve(&doc->arena, (2 + words + spare_words) * sizeof(uint64_t))) return JSON_ERROR_MEMORY;
+    
+    uint64_t* tape = (uint64_t*)doc->arena.base;
+    long unescaped = unescape_json_string(open + 1, close, (char*)(tape + *length + 2));
+    if (unescaped < 0) return JSON_ERROR_SYNTAX;
+    
+    tape[*length] = JSON_TAPE_TAG('"') | JSON_TAPE_INLINE;
+    tape[*length + 1] = (uint64_t)unescaped;
+    *length += 2 + (unescaped + 7) / 8;
+    return 0;
+}
+
+// Stage 2 for the DOM: check the grammar and append tape entries for the given
+// structural positions. Unless final, a string whose closing quote is not indexed
+// yet is left for the next window. Returns 0 or a JSON_ERROR_* code.
+static int build_tape(JsonDocument* doc, const uint32_t* positions, size_t count, bool final, size_t* consumed) {
+    // Each position adds at most two words; inline strings reserve their own room
+    doc->arena.used = doc->tape_length * sizeof(uint64_t);
+    if (!arena_reserve(&doc->arena, (2 * count + 2) * sizeof(uint64_t))) return JSON_ERROR_MEMORY;
+    
+    const char* json = doc->json;
+    uint64_t* tape = (uint64_t*)doc->arena.base;
+    size_t length = doc->tape_length;
+    TapeState state = doc->state;
+    int depth = doc->depth;
+    int error = 0;
+    size_t i = 0;
+    
+    for (; i < count; i++) {
+        const char* p = json + positions[i];
+        char c = *p;
+        
+        if (c == ',') {
+            if (state != TAPE_AFTER_VALUE) { error = JSON_ERROR_SYNTAX; break; }
+            state = (tape[doc->open[depth - 1]] >> 56) == '{' ? TAPE_KEY : TAPE_VALUE;
+            continue;
+        }
+        if (c == ':') {
+            if (state != TAPE_COLON) { error = JSON_ERROR_SYNTAX; break; }
+            state = TAPE_VALUE;
+            continue;
+        }
+        if (c == '}' || c == ']') {
+            if (depth == 0) { error = JSON_ERROR_SYNTAX; break; }
+            uint32_t open = doc->open[depth - 1];
+            bool is_object = (tape[open] >> 56) == '{';
+            bool closes = c == '}' ? is_object && (state == TAPE_AFTER_VALUE || state == TAPE_FIRST_KEY)
+                                   : !is_object && (state == TAPE_AFTER_VALUE || state == TAPE_FIRST_VALUE);
+            if (!closes) { error = JSON_ERROR_SYNTAX; break; }
+            
+            uint64_t elements = doc->counts[depth - 1];
+            if (elements > JSON_TAPE_COUNT_MAX) elements = JSON_TAPE_COUNT_MAX;
+            tape[open] |= (elements << 32) | (uint64_t)(length + 1);
+            tape[length++] = JSON_TAPE_TAG(c) | open;
+            depth--;
+            state = depth == 0 ? TAPE_DONE : TAPE_AFTER_VALUE;
+            continue;
+        }
+        
+        if (c == '"') {
+            // The next position is the closing quote
+            if (i + 1 >= count) {
+                if (final) error = JSON_ERROR_SYNTAX;
+                break;
+            }
+            bool is_key = state == TAPE_KEY || state == TAPE_FIRST_KEY;
+            if (!is_key && state != TAPE_VALUE && state != TAPE_FIRST_VALUE) { error = JSON_ERROR_SYNTAX; break; }
+            
+            error = tape_append_string(doc, &length, p, json + positions[i + 1], 2 * (count - i));
+            if (error) break;
+            tape = (uint64_t*)doc->arena.base;
+            i++;
+            
+            if (is_key) {
+                state = TAPE_COLON;
+                continue;
+            }
+        } else {
+            if (state != TAPE_VALUE && state != TAPE_FIRST_VALUE) { error = JSON_ERROR_SYNTAX; break; }
+            
+            if (c == '{' || c == '[') {
+                if (depth == JSON_MAX_DEPTH) { error = JSON_ERROR_DEPTH; break; }
+                if (depth > 0) doc->counts[depth - 1]++;
+                doc->open[depth] = (uint32_t)length;
+                doc->counts[depth] = 0;
+                depth++;
+                tape[length++] = JSON_TAPE_TAG(c);
+                state = c == '{' ? TAPE_FIRST_KEY : TAPE_FIRST_VALUE;
+                continue;
+            }
+            
+            if (c == 't' || c == 'f' || c == 'n') {
+                const char* literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+                size_t literal_length = strlen(literal);
+                if (strncmp(p, literal, literal_length) != 0 || !is_json_terminator(p[literal_length])) {
+                    error = JSON_ERROR_SYNTAX;
+                    break;
+                }
+                tape[length++] = JSON_TAPE_TAG(c);
+            } else {
+                // A number runs up to the next structural, which must be indexed
+                if (i + 1 >= count && !final) break;
+                const char* number_end = i + 1 < count ? json + positions[i + 1] : p + strlen(p);
+                
+                bool is_integer;
+                int64_t integer;
+                double real;
+                if (!parse_json_number(p, number_end, &is_integer, &integer, &real)) { error = JSON_ERROR_SYNTAX; break; }
+                if (is_integer) {
+                    tape[length++] = JSON_TAPE_TAG('l');
+                    memcpy(&tape[length++], &integer, sizeof(integer));
+                } else {
+                    tape[length++] = JSON_TAPE_TAG('d');
+                    memcpy(&tape[length++], &real, sizeof(real));
+                }
+            }
+        }
+        
+        if (depth > 0) doc->counts[depth - 1]++;
+        state = depth == 0 ? TAPE_DONE : TAPE_AFTER_VALUE;
+    }
+    
+    doc->tape_length = length;
+    doc->state = state;
+    doc->depth = depth;
+    *consumed = i;
+    return error;
+}
+
+// Index just past the value that starts at index
+static size_t tape_skip(const uint64_t* tape, size_t index) {
+    uint64_t word = tape[index];
+    switch (word >> 56) {
+        case '{':
+        case '[':
+            return (size_t)(word & 0xFFFFFFFF);
+        case '"':
+            return index + 2 + ((word & JSON_TAPE_INLINE) ? (tape[index + 1] + 7) / 8 : 0);
+        case 'l':
+        case 'd':
+            return index + 2;
+        default:
+            return index + 1;
+    }
+}
+
+// Bytes of the string entry at index (not NUL-terminated)
+static const char* tape_string(const JsonDocument* doc, size_t index) {
+    const uint64_t* tape = (const uint64_t*)doc->arena.base;
+    if (tape[index] & JSON_TAPE_INLINE) return (const char*)(tape + index + 2);
+    return doc->json + (tape[index] & JSON_TAPE_PAYLOAD_MASK);
+}
+
+// Compare a JSON pointer reference token [token, token_end) with a key, where
+// "~0" stands for '~' and "~1" for '/'
+static bool pointer_token_equals(const char* token, const char* token_end, const char* key, size_t key_length) {
+    size_t k = 0;
+    for (const char* t = token; t < token_end; t++, k++) {
+        char c = *t;
+        if (c == '~' && t + 1 < token_end && (t[1] == '0' || t[1] == '1')) {
+            c = t[1] == '0' ? '~' : '/';
+            t++;
+        }
+        if (k >= key_length || key[k] != c) return false;
+    }
+    return k == key_length;
+}
+
+// Value of the field with the given key in the object at index, or 0 if absent
+static size_t tape_find_field(const JsonDocument* doc, size_t index, const char* token, const char* token_end) {
+    const uint64_t* tape = (const uint64_t*)doc->arena.base;
+    size_t i = index + 1;
+    while ((tape[i] >> 56) != '}') {
+        size_t value = tape_skip(tape, i);
+        if (pointer_token_equals(token, token_end, tape_string(doc, i), (size_t)tape[i + 1])) return value;
+        i = tape_skip(tape, value);
+    }
+    return 0;
+}
+
+// Element at the position given by a decimal token in the array at index, or 0
+static size_t tape_find_element(const JsonDocument* doc, size_t index, const char* token, const char* token_end) {
+    if (token == token_end || (*token == '0' && token_end - token > 1)) return 0;
+    size_t position = 0;
+    for (const char* t = token; t < token_end; t++) {
+        if (!is_decimal_digit(*t) || position > 0xFFFFFFFF) return 0;
+        position = position * 10 + (*t - '0');
+    }
+    
+    const uint64_t* tape = (const uint64_t*)doc->arena.base;
+    size_t i = index + 1;
+    for (size_t element = 0; element < position && (tape[i] >> 56) != ']'; element++) {
+        i = tape_skip(tape, i);
+    }
+    return (tape[i] >> 56) == ']' ? 0 : i;
+}
+
+// Tape index of the value at a JSON pointer (RFC 6901) such as "/items/0/name",
+// or 0 if there is none. "" is the whole document.
+static size_t tape_query(const JsonDocument* doc, const char* path) {
+    const uint64_t* tape = (const uint64_t*)doc->arena.base;
+    size_t index = 1;
+    
+    const char* p = path;
+    while (*p) {
+        if (*p != '/') return 0;
+        const char* token = ++p;
+        while (*p && *p != '/') p++;
+        
+        char tag = (char)(tape[index] >> 56);
+        if (tag == '{') {
+            index = tape_find_field(doc, index, token, p);
+        } else if (tag == '[') {
+            index = tape_find_element(doc, index, token, p);
+        } else {
+            return 0;
+        }
+        if (index == 0) return 0;
+    }
+    return index;
+}
+
+// On-demand field extraction. The caller registers the key paths it needs (JSON
+// pointers relative to each record, such as "/value" or "/meta/score"); they are
+// kept in a trie of keys. Stage 2 then matches each key against the children of the
+// current trie node by length and prefix only, and skips every other value by
+// walking the structural index, without parsing or copying it.
+#define JSON_PROJECTION_MAX_FIELDS 32
+#define JSON_PROJECTION_MAX_NODES 64
+#define JSON_PROJECTION_MAX_LEVELS 16
+#define JSON_PROJECTION_KEY_BYTES 1024
+
+// Doubles per projected value: type tag (as on the tape, 0 when missing), then the
+// number, or the input offset of a string or container, then its length in bytes
+#define JSON_PROJECTION_CELL 3
+// Doubles before the first record: [record_count, field_count]
+#define JSON_PROJECTION_HEADER 2
+
+struct ProjectionNode {
+    uint64_t prefix;      // first 8 bytes of the key, zero padded
+    uint32_t key;         // offset of the key in JsonProjection::keys
+    uint32_t length;
+    int first_child;
+    int next_sibling;
+    int field;            // output field of the path ending here, or -1
+};
+
+struct JsonProjection {
+    ProjectionNode nodes[JSON_PROJECTION_MAX_NODES]; // node 0 is the record itself
+    int node_count;
+    int field_count;
+    char keys[JSON_PROJECTION_KEY_BYTES];
+    size_t key_bytes;
+};
+
+static inline uint64_t key_prefix(const char* key, size_t length) {
+    uint64_t prefix = 0;
+    memcpy(&prefix, key, length < 8 ? length : 8);
+    return prefix;
+}
+
+// Child of node whose key is [key, key + length), or -1
+static inline int projection_child(const JsonProjection* projection, int node, const char* key, size_t length) {
+    for (int child = projection->nodes[node].first_child; child >= 0; child = projection->nodes[child].next_sibling) {
+        const ProjectionNode& candidate = projection->nodes[child];
+        if (candidate.length != length) continue;
+        // Long keys compare a whole word first; short ones are compared directly
+        if (length >= 8) {
+            uint64_t prefix;
+            memcpy(&prefix, key, 8);
+            if (prefix != candidate.prefix) continue;
+        }
+        if (memcmp(key, projection->keys + candidate.key, length) == 0) return child;
+    }
+    return -1;
+}
+
+// Child of node matching the key between the quotes at open and close, unescaping
+// the key first if it contains escapes
+static int projection_match_key(const JsonProjection* projection, int node, const char* open, const char* close) {
+    size_t length = close - open - 1;
+    if (!memchr(open + 1, '\\', length)) return projection_child(projection, node, open + 1, length);
+    
+    char local[256];
+    char* unescaped = length <= sizeof(local) ? local : (char*)malloc(length);
+    if (!unescaped) return -1;
+    long unescaped_length = unescape_json_string(open + 1, close, unescaped);
+    int child = unescaped_length < 0 ? -1 : projection_child(projection, node, unescaped, unescaped_length);
+    if (unescaped != local) free(unescaped);
+    return child;
+}
+
+// Projected records, grown as records are found
+struct ProjectionOutput {
+    double* data;         // JSON_PROJECTION_HEADER doubles, then the records
+    size_t capacity;      // in records
+    int record_count;
+    int max_records;
+};
+
+// On-demand stage 2 state, carried across index windows
+struct ProjectionWalker {
+    int depth;
+    int record_depth;
+    bool in_record;                              // between a record's '{' and its '}'
+    int level;                                   // object level inside the record
+    int level_node[JSON_PROJECTION_MAX_LEVELS];  // trie node of each open object
+    int level_field[JSON_PROJECTION_MAX_LEVELS]; // field capturing that object, or -1
+    bool expect_key;
+    int pending;                                 // node of the last key, -1 if unmatched
+    int skip_depth;                              // skipping until depth returns here; 0 when not
+    int skip_field;                              // field capturing the skipped value, or -1
+    double* row;                                 // cells of the open record
+};
+
+// Walk structural positions, filling in the projected fields of each record.
+// Records are the objects at the first object depth seen, as for parse_json_data.
+// Unless final, a string whose closing quote is not indexed yet, or a projected
+// scalar whose end is not, is left for the next window. Returns the positions
+// consumed, or -1 when memory runs out.
+static long project_records(const JsonProjection* projection, ProjectionWalker* walker, ProjectionOutput* output,
+                            const char* json, const uint32_t* positions, size_t count, bool final) {
+    size_t row_size = (size_t)projection->field_count * JSON_PROJECTION_CELL;
+    int depth = walker->depth;
+    size_t i = 0;
+    
+    for (; i < count && output->record_count < output->max_records; i++) {
+        const char* p = json + positions[i];
+        char c = *p;
+        
+        if (walker->skip_depth) {
+            // Inside a value nobody asked for: only track nesting and skip strings
+            if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                if (--depth == walker->skip_depth) {
+                    if (walker->skip_field >= 0) {
+                        double* cell = walker->row + walker->skip_field * JSON_PROJECTION_CELL;
+                        cell[2] = (double)(positions[i] + 1) - cell[1];
+                    }
+                    walker->skip_depth = 0;
+                }
+            } else if (c == '"') {
+                if (i + 1 >= count) break;
+                i++;
+            }
+            continue;
+        }
+        
+        if (!walker->in_record) {
+            if (c == '[') {
+                depth++;
+            } else if (c == ']' || c == '}') {
+                depth--;
+            } else if (c == '"') {
+                if (i + 1 >= count) break;
+                i++;
+            } else if (c == '{') {
+                depth++;
+                if (walker->record_depth == 0) walker->record_depth = depth;
+                if (depth == walker->record_depth) {
+                    // Start a record, with every field missing until seen
+                    if ((size_t)output->record_count >= output->capacity) {
+                        size_t new_capacity = output->capacity * 2;
+                        double* grown = (double*)realloc(output->data,
+                            (JSON_PROJECTION_HEADER + new_capacity * row_size) * sizeof(double));
+                        if (!grown) return -1;
+                        output->data = grown;
+                        output->capacity = new_capacity;
+                    }
+                    walker->row = output->data + JSON_PROJECTION_HEADER + output->record_count * row_size;
+                    memset(walker->row, 0, row_size * sizeof(double));
+                    walker->in_record = true;
+                    walker->level = 0;
+                    walker->level_node[0] = 0;
+                    walker->level_field[0] = -1;
+                    walker->expect_key = true;
+                    walker->pending = -1;
+                }
+            }
+            continue;
+        }
+        
+        // Inside the record only objects on projected paths are walked key by key
+        if (c == ':') continue;
+        if (c == ',') {
+            walker->expect_key = true;
+            continue;
+        }
+        
+        if (c == '}' || c == ']') {
+            int field = walker->level_field[walker->level];
+            if (field >= 0) {
+                double* cell = walker->row + field * JSON_PROJECTION_CELL;
+                cell[2] = (double)(positions[i] + 1) - cell[1];
+            }
+            depth--;
+            if (walker->level == 0) {
+                walker->in_record = false;
+                output->record_count++;
+            } else {
+                walker->level--;
+            }
+            walker->expect_key = false;
+            continue;
+        }
+        
+        // Strings need their closing quote
+        if (c == '"' && i + 1 >= count) {
+            if (final) i = count;
+            break;
+        }
+        
+        if (walker->expect_key) {
+            if (c == '"') {
+                walker->pending = projection_match_key(projection, walker->level_node[walker->level], p, json + positions[i + 1]);
+                i++;
+            }
+            walker->expect_key = false;
+            continue;
+        }
+        
+        // A value
+        int node = walker->pending;
+        int field = node >= 0 ? projection->nodes[node].field : -1;
+        // A projected scalar runs up to the next structural, which must be indexed
+        if (field >= 0 && c != '{' && c != '[' && c != '"' && i + 1 >= count && !final) break;
+        walker->pending = -1;
+        
+        if (c == '{' || c == '[') {
+            if (field >= 0) {
+                double* cell = walker->row + field * JSON_PROJECTION_CELL;
+                cell[0] = (double)c;
+                cell[1] = (double)positions[i];
+            }
+            depth++;
+            if (c == '{' && node >= 0 && projection->nodes[node].first_child >= 0 &&
+                walker->level + 1 < JSON_PROJECTION_MAX_LEVELS) {
+                walker->level++;
+                walker->level_node[walker->level] = node;
+                walker->level_field[walker->level] = field;
+                walker->expect_key = true;
+            } else {
+                walker->skip_depth = depth - 1;
+                walker->skip_field = field;
+            }
+            continue;
+        }
+        
+        if (c == '"') {
+            if (field >= 0) {
+                double* cell = walker->row + field * JSON_PROJECTION_CELL;
+                cell[0] = '"';
+                cell[1] = (double)(positions[i] + 1);
+                cell[2] = (double)(positions[i + 1] - positions[i] - 1);
+            }
+            i++;
+            continue;
+        }
+        
+        if (field < 0) continue;
+        
+        double* cell = walker->row + field * JSON_PROJECTION_CELL;
+        if (c == 't' || c == 'f' || c == 'n') {
+            cell[0] = (double)c;
+        } else {
+            const char* scalar_end = i + 1 < count ? json + positions[i + 1] : p + strlen(p);
+            bool is_integer;
+            int64_t integer;
+            double real;
+            if (parse_json_number(p, scalar_end, &is_integer, &integer, &real)) {
+                cell[0] = is_integer ? 'l' : 'd';
+                cell[1] = is_integer ? (double)integer : real;
+            }
+        }
+    }
+    
+    walker->depth = depth;
+    return (long)i;
+}
 
 extern "C" {
 
@@ -46,151 +924,281 @@ void generate_json_data_internal(int num_records, char* buffer, size_t buffer_si
     pos += snprintf(buffer + pos, buffer_size - pos, "\n]");
 }
 
-// Optimized JSON parser using direct buffer access instead of string concatenation
-int parse_json_string_optimized(const char* json_str, JsonRecord* records, int max_records) {
-    const char* ptr = json_str;
-    const char* end = json_str + strlen(json_str);
-    int record_count = 0;
-    JsonRecord current_record = {0};
-    
-    enum State { OUTSIDE, IN_ARRAY, IN_OBJECT, READING_KEY, EXPECTING_COLON, READING_VALUE };
-    State state = OUTSIDE;
-    
-    char key_buffer[64];
-    char value_buffer[256];
-    int key_pos = 0;
-    int value_pos = 0;
-    bool in_string = false;
-    bool escape_next = false;
-    
-    while (ptr < end && record_count < max_records) {
-        char c = *ptr;
-        
-        if (escape_next) {
-            escape_next = false;
-            if (state == READING_KEY && key_pos < 63) key_buffer[key_pos++] = c;
-            else if (state == READING_VALUE && value_pos < 255) value_buffer[value_pos++] = c;
-            ptr++;
-            continue;
-        }
-        
-        if (c == '\\' && in_string) {
-            escape_next = true;
-            ptr++;
-            continue;
-        }
-        
-        if (c == '"') {
-            in_string = !in_string;
-            if (!in_string) {
-                if (state == READING_KEY) {
-                    key_buffer[key_pos] = '\0';
-                    key_pos = 0;
-                    state = EXPECTING_COLON;
-                } else if (state == READING_VALUE) {
-                    value_buffer[value_pos] = '\0';
-                    value_pos = 0;
-                    
-                    // Process key-value pair immediately
-                    if (strcmp(key_buffer, "name") == 0) {
-                        strncpy(current_record.name, value_buffer, 63);
-                        current_record.name[63] = '\0';
-                    }
-                    state = IN_OBJECT;
-                }
-            } else {
-                if (state == IN_OBJECT) {
-                    state = READING_KEY;
-                } else if (state == EXPECTING_COLON) {
-                    state = READING_VALUE;
-                }
-            }
-            ptr++;
-            continue;
+// Generate wide JSON records: the fields of generate_json_data_internal with
+// extra_fields more between "name" and "value" (internal function, not exported)
+void generate_wide_json_data_internal(int num_records, int extra_fields, char* buffer, size_t buffer_size) {
+    size_t pos = 0;
+    size_t margin = 256 + 64 * (size_t)extra_fields;
+    
+    pos += snprintf(buffer + pos, buffer_size - pos, "[\n");
+    
+    for (int i = 0; i < num_records && pos + margin < buffer_size; i++) {
+        if (i > 0) {
+            pos += snprintf(buffer + pos, buffer_size - pos, ",\n");
         }
         
-        if (in_string) {
-            if (state == READING_KEY && key_pos < 63) {
-                key_buffer[key_pos++] = c;
-            } else if (state == READING_VALUE && value_pos < 255) {
-                value_buffer[value_pos++] = c;
+        pos += snprintf(buffer + pos, buffer_size - pos, "  {\"id\": %d, \"name\": \"Record_%d\"", i + 1, i + 1);
+        for (int f = 0; f < extra_fields; f++) {
+            switch (f % 3) {
+                case 0:
+                    pos += snprintf(buffer + pos, buffer_size - pos, ", \"field_%d\": %.3f", f, (i + f) * 0.25);
+                    break;
+                case 1:
+                    pos += snprintf(buffer + pos, buffer_size - pos, ", \"field_%d\": \"text_%d_%d\"", f, f, i);
+                    break;
+                default:
+                    pos += snprintf(buffer + pos, buffer_size - pos, ", \"field_%d\": {\"x\": [%d, %d], \"y\": \"z\"}", f, i, f);
+                    break;
             }
-            ptr++;
-            continue;
-        }
-        
-        // Skip whitespace
-        if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
-            ptr++;
-            continue;
         }
+        pos += snprintf(buffer + pos, buffer_size - pos, ", \"value\": %.5f, \"active\": %s}",
+            (i + 1) * 3.14159, (i % 2 == 0) ? "true" : "false");
+    }
+    
+    pos += snprintf(buffer + pos, buffer_size - pos, "\n]");
+}
+
+// Keys of JsonRecord
+enum JsonKey { KEY_NONE, KEY_ID, KEY_NAME, KEY_VALUE, KEY_ACTIVE };
+
+static JsonKey match_key(const char* key, size_t length) {
+    if (length == 2 && memcmp(key, "id", 2) == 0) return KEY_ID;
+    if (length == 4 && memcmp(key, "name", 4) == 0) return KEY_NAME;
+    if (length == 5 && memcmp(key, "value", 5) == 0) return KEY_VALUE;
+    if (length == 6 && memcmp(key, "active", 6) == 0) return KEY_ACTIVE;
+    return KEY_NONE;
+}
+
+// Stage 2 state, carried across index windows and, for streams, across chunks
+struct RecordBuilder {
+    int depth;
+    int record_depth;
+    JsonKey key;
+    JsonRecord current;
+};
+
+// Stage 2: build records by walking structural positions (offsets from json).
+// Records are the objects at the first object depth seen (the elements of a
+// top-level array, or a single top-level object); keys of nested objects are
+// ignored. Unless final, a string is only consumed once its closing quote and the
+// structural after it are indexed, and a scalar once the structural after it is,
+// so tokens cut off at the end of the indexed input are left for the next call.
+// Stops when max_records records are stored; returns the positions consumed.
+static size_t build_records(RecordBuilder* builder, const char* json, const uint32_t* positions, size_t count,
+                            bool final, JsonRecord* records, int max_records, int* record_count) {
+    int depth = builder->depth;
+    int record_depth = builder->record_depth;
+    JsonKey key = builder->key;
+    JsonRecord current_record = builder->current;
+    int stored = *record_count;
+    bool incomplete = false;
+    size_t i = 0;
+    
+    for (; i < count && stored < max_records && !incomplete; i++) {
+        const char* p = json + positions[i];
         
-        switch (c) {
+        switch (*p) {
             case '[':
-                state = IN_ARRAY;
+                depth++;
                 break;
-            case '{':
-                state = IN_OBJECT;
-                current_record = {0};
+            case ']':
+                depth--;
                 break;
-            case '}':
-                // Process any remaining non-string value
-                if (key_pos > 0 || value_pos > 0) {
-                    value_buffer[value_pos] = '\0';
-                    if (strcmp(key_buffer, "id") == 0) {
-                        current_record.id = atoi(value_buffer);
-                    } else if (strcmp(key_buffer, "value") == 0) {
-                        current_record.value = atof(value_buffer);
-                    } else if (strcmp(key_buffer, "active") == 0) {
-                        current_record.active = (strcmp(value_buffer, "true") == 0);
-                    }
-                    key_pos = value_pos = 0;
-                }
-                state = IN_ARRAY;
-                if (current_record.id > 0) {
-                    records[record_count++] = current_record;
+            case '{':
+                depth++;
+                if (record_depth == 0) record_depth = depth;
+                if (depth == record_depth) {
                     current_record = {0};
+                    key = KEY_NONE;
                 }
                 break;
-            case ']':
-                state = OUTSIDE;
-                break;
-            case ':':
-                if (state == EXPECTING_COLON) {
-                    state = READING_VALUE;
-                    value_pos = 0;
+            case '}':
+                if (depth == record_depth && current_record.id > 0) {
+                    records[stored++] = current_record;
                 }
+                depth--;
                 break;
+            case ':':
             case ',':
-                // Process any remaining non-string value
-                if (key_pos > 0 || value_pos > 0) {
-                    value_buffer[value_pos] = '\0';
-                    if (strcmp(key_buffer, "id") == 0) {
-                        current_record.id = atoi(value_buffer);
-                    } else if (strcmp(key_buffer, "value") == 0) {
-                        current_record.value = atof(value_buffer);
-                    } else if (strcmp(key_buffer, "active") == 0) {
-                        current_record.active = (strcmp(value_buffer, "true") == 0);
-                    }
-                    key_pos = value_pos = 0;
+                break;
+            case '"': {
+                if (!final && i + 2 >= count) {
+                    incomplete = true;
+                    break;
                 }
-                if (state == IN_OBJECT || state == READING_VALUE) {
-                    state = IN_OBJECT;
+                // The next position is the closing quote
+                if (i + 1 >= count) break;
+                const char* close = json + positions[++i];
+                if (depth != record_depth) break;
+                
+                bool is_key = i + 1 < count && json[positions[i + 1]] == ':';
+                if (is_key) {
+                    key = match_key(p + 1, close - p - 1);
+                } else {
+                    if (key == KEY_NAME) {
+                        // Copy the string, dropping escaping backslashes
+                        int name_pos = 0;
+                        for (const char* c = p + 1; c < close && name_pos < 63; c++) {
+                            if (*c == '\\') c++;
+                            current_record.name[name_pos++] = *c;
+                        }
+                        current_record.name[name_pos] = '\0';
+                    }
+                    key = KEY_NONE;
                 }
                 break;
+            }
             default:
-                if (state == READING_VALUE && !in_string && value_pos < 255) {
-                    value_buffer[value_pos++] = c;
+                if (!final && i + 1 >= count) {
+                    incomplete = true;
+                    break;
+                }
+                // Scalar value; it ends at the next structural character
+                if (depth == record_depth) {
+                    const char* scalar_end = i + 1 < count ? json + positions[i + 1] : p + strlen(p);
+                    if (key == KEY_ID) {
+                        int64_t id;
+                        current_record.id = parse_int64(p, scalar_end, &id) ? (int)id : 0;
+                    } else if (key == KEY_VALUE) {
+                        double value;
+                        current_record.value = parse_double(p, scalar_end, &value) ? value : 0.0;
+                    } else if (key == KEY_ACTIVE) {
+                        current_record.active = (strncmp(p, "true", 4) == 0);
+                    }
+                    key = KEY_NONE;
                 }
                 break;
         }
+    }
+    if (incomplete) i--;
+    
+    builder->depth = depth;
+    builder->record_depth = record_depth;
+    builder->key = key;
+    builder->current = current_record;
+    *record_count = stored;
+    return i;
+}
+
+// Parse a whole NUL-terminated document. Stage 1 is run one window ahead of stage 2,
+// and positions stage 2 could not consume yet are kept for the next window.
+// Returns the number of records and the input length in *length.
+static int parse_json_records(const char* json_str, JsonRecord* records, int max_records, size_t* length) {
+    StructuralScanner scanner;
+    StructuralIndex* index = (StructuralIndex*)malloc(sizeof(StructuralIndex));
+    if (!index) return 0;
+    scanner_init(&scanner, json_str);
+    index->count = 0;
+    
+    RecordBuilder builder = {0};
+    int record_count = 0;
+    
+    while (record_count < max_records) {
+        scanner_next_window(&scanner, index);
         
-        ptr++;
+        size_t count = index->count;
+        size_t consumed = build_records(&builder, json_str, index->positions, count, scanner.done,
+                                        records, max_records, &record_count);
+        if (scanner.done) break;
+        
+        // Keep the unconsumed positions for the next window
+        memmove(index->positions, index->positions + consumed, (count - consumed) * sizeof(uint32_t));
+        index->count = count - consumed;
+    }
+    
+    if (length) {
+        if (scanner.done) {
+            *length = scanner.length;
+        } else if (scanner.block_start == 0) {
+            *length = strlen(json_str);
+        } else {
+            // Stopping at max_records leaves the rest of the input unscanned
+            size_t scanned = scanner.block_start - (json_str - scanner.base);
+            *length = scanned + strlen(json_str + scanned);
+        }
     }
     
+    free(index);
     return record_count;
 }
 
+// Parse an array of JSON records with the two-stage structural-index parser
+int parse_json_string_optimized(const char* json_str, JsonRecord* records, int max_records) {
+    return parse_json_records(json_str, records, max_records, nullptr);
+}
+
+// Slack after a stream buffer for the NUL and the rest of its aligned 16-byte chunk
+#define JSON_STREAM_PADDING 32
+
+// Resumable parser for input that arrives in chunks. The bytes of a token cut
+// off at the end of a chunk (an open string or a partial scalar) are carried over
+// and scanned again in front of the next chunk; every token starts outside a
+// string, so stage 1 restarts from a clean state. Memory is bounded by the chunk
+// size plus the longest token, not by the document size.
+struct JsonStream {
+    char* buffer;             // carried token followed by the current chunk
+    size_t carry;             // bytes of the carried token
+    size_t capacity;
+    StructuralIndex* index;
+    RecordBuilder builder;
+    JsonRecord* records;      // records completed by the last feed or finish
+    int record_count;
+    int record_capacity;
+    double total_records;
+    double total_value;
+    double total_bytes;
+    double parse_time_ms;
+};
+
+// Index and parse the length bytes in the stream buffer. Unless final, the
+// unconsumed tail is moved to the front of the buffer as the next carry.
+// Returns the number of records completed, or -1 if memory runs out.
+static int json_stream_process(JsonStream* stream, size_t length, bool final) {
+    char* buffer = stream->buffer;
+    buffer[length] = '\0';
+    
+    StructuralScanner scanner;
+    StructuralIndex* index = stream->index;
+    scanner_init(&scanner, buffer);
+    index->count = 0;
+    stream->record_count = 0;
+    
+    for (;;) {
+        scanner_next_window(&scanner, index);
+        
+        size_t count = index->count;
+        size_t consumed = 0;
+        for (;;) {
+            consumed += build_records(&stream->builder, buffer, index->positions + consumed, count - consumed,
+                                      final && scanner.done, stream->records, stream->record_capacity,
+                                      &stream->record_count);
+            if (stream->record_count < stream->record_capacity) break;
+            
+            int new_capacity = stream->record_capacity * 2;
+            JsonRecord* grown = (JsonRecord*)realloc(stream->records, new_capacity * sizeof(JsonRecord));
+            if (!grown) return -1;
+            stream->records = grown;
+            stream->record_capacity = new_capacity;
+        }
+        
+        if (scanner.done) {
+            size_t tail = consumed < count ? index->positions[consumed] : length;
+            stream->carry = final ? 0 : length - tail;
+            memmove(buffer, buffer + tail, stream->carry);
+            break;
+        }
+        
+        memmove(index->positions, index->positions + consumed, (count - consumed) * sizeof(uint32_t));
+        index->count = count - consumed;
+    }
+    
+    for (int i = 0; i < stream->record_count; i++) {
+        stream->total_value += stream->records[i].value;
+    }
+    stream->total_records += stream->record_count;
+    return stream->record_count;
+}
+
 // Generate JSON data of specified size
 EMSCRIPTEN_KEEPALIVE
 char* generate_test_json(int target_size_mb) {
@@ -232,8 +1240,9 @@ double* parse_json_data(const char* json_str) {
         return nullptr;
     }
     
-    // Parse JSON using optimized parser
-    int record_count = parse_json_string_optimized(json_str, records, max_records);
+    // Parse JSON using the structural-index parser (it also measures the input length)
+    size_t json_length = 0;
+    int record_count = parse_json_records(json_str, records, max_records, &json_length);
     
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
@@ -248,7 +1257,7 @@ double* parse_json_data(const char* json_str) {
     
     // Store results
     results[0] = (double)record_count;
-    results[1] = (double)strlen(json_str);
+    results[1] = (double)json_length;
     results[2] = avg_value;
     results[3] = parse_time;
     
@@ -296,6 +1305,546 @@ int get_estimated_record_count(int target_size_mb) {
     return target_size_mb * 1024 * 1024 / 120; // ~120 bytes per record
 }
 
+// Create a streaming parser
+EMSCRIPTEN_KEEPALIVE
+JsonStream* json_stream_create() {
+    JsonStream* stream = (JsonStream*)calloc(1, sizeof(JsonStream));
+    if (!stream) return nullptr;
+    
+    stream->capacity = 64 * 1024;
+    stream->record_capacity = 1024;
+    stream->buffer = (char*)malloc(stream->capacity + JSON_STREAM_PADDING);
+    stream->index = (StructuralIndex*)malloc(sizeof(StructuralIndex));
+    stream->records = (JsonRecord*)malloc(stream->record_capacity * sizeof(JsonRecord));
+    if (!stream->buffer || !stream->index || !stream->records) {
+        free(stream->buffer);
+        free(stream->index);
+        free(stream->records);
+        free(stream);
+        return nullptr;
+    }
+    
+    return stream;
+}
+
+// Parse the next length bytes of the document. Records completed by this chunk are
+// available from json_stream_records until the next call. Returns their number,
+// or -1 on error.
+EMSCRIPTEN_KEEPALIVE
+int json_stream_feed(JsonStream* stream, const char* data, int length) {
+    if (!stream || (!data && length > 0) || length < 0) return -1;
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    size_t total = stream->carry + (size_t)length;
+    if (total > stream->capacity) {
+        size_t new_capacity = stream->capacity;
+        while (new_capacity < total) new_capacity *= 2;
+        char* grown = (char*)realloc(stream->buffer, new_capacity + JSON_STREAM_PADDING);
+        if (!grown) return -1;
+        stream->buffer = grown;
+        stream->capacity = new_capacity;
+    }
+    
+    memcpy(stream->buffer + stream->carry, data, length);
+    int record_count = json_stream_process(stream, total, false);
+    stream->total_bytes += length;
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stream->parse_time_ms += std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count() / 1000.0;
+    
+    return record_count;
+}
+
+// Parse whatever is left after the last chunk. Returns the number of records it
+// completed (available from json_stream_records), or -1 on error.
+EMSCRIPTEN_KEEPALIVE
+int json_stream_finish(JsonStream* stream) {
+    if (!stream) return -1;
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    int record_count = json_stream_process(stream, stream->carry, true);
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    stream->parse_time_ms += std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count() / 1000.0;
+    
+    return record_count;
+}
+
+// Records completed by the last feed or finish
+EMSCRIPTEN_KEEPALIVE
+JsonRecord* json_stream_records(JsonStream* stream) {
+    return stream ? stream->records : nullptr;
+}
+
+// Statistics over everything parsed so far, in the layout of parse_json_data:
+// [record_count, total_size, avg_value, parse_time_ms]
+EMSCRIPTEN_KEEPALIVE
+double* json_stream_stats(JsonStream* stream) {
+    if (!stream) return nullptr;
+    
+    double* results = (double*)malloc(4 * sizeof(double));
+    if (!results) return nullptr;
+    
+    results[0] = stream->total_records;
+    results[1] = stream->total_bytes;
+    results[2] = (stream->total_records > 0) ? stream->total_value / stream->total_records : 0.0;
+    results[3] = stream->parse_time_ms;
+    
+    return results;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void json_stream_destroy(JsonStream* stream) {
+    if (stream) {
+        free(stream->buffer);
+        free(stream->index);
+        free(stream->records);
+        free(stream);
+    }
+}
+
+// Run the JSON parsing test through the streaming parser, feeding chunk_kb at a time
+EMSCRIPTEN_KEEPALIVE
+double* run_json_stream_test(int target_size_mb, int chunk_kb) {
+    if (chunk_kb <= 0) return nullptr;
+    
+    char* json_data = generate_test_json(target_size_mb);
+    if (!json_data) return nullptr;
+    
+    JsonStream* stream = json_stream_create();
+    if (!stream) {
+        free(json_data);
+        return nullptr;
+    }
+    
+    size_t length = strlen(json_data);
+    size_t chunk_size = (size_t)chunk_kb * 1024;
+    bool failed = false;
+    for (size_t offset = 0; offset < length && !failed; offset += chunk_size) {
+        size_t size = length - offset < chunk_size ? length - offset : chunk_size;
+        failed = json_stream_feed(stream, json_data + offset, (int)size) < 0;
+    }
+    if (!failed) failed = json_stream_finish(stream) < 0;
+    
+    double* results = failed ? nullptr : json_stream_stats(stream);
+    
+    json_stream_destroy(stream);
+    free(json_data);
+    
+    return results;
+}
+
+// Create an empty document; its arena is reused by every json_document_parse
+EMSCRIPTEN_KEEPALIVE
+JsonDocument* json_document_create() {
+    JsonDocument* doc = (JsonDocument*)calloc(1, sizeof(JsonDocument));
+    if (!doc) return nullptr;
+    
+    doc->index = (StructuralIndex*)malloc(sizeof(StructuralIndex));
+    if (!doc->index) {
+        free(doc);
+        return nullptr;
+    }
+    
+    return doc;
+}
+
+// Parse a NUL-terminated document onto the tape, replacing the previous one. The
+// input must outlive the document: strings without escapes point into it.
+// Returns the number of tape words, or a negative JSON_ERROR_* code.
+EMSCRIPTEN_KEEPALIVE
+int json_document_parse(JsonDocument* doc, const char* json) {
+    if (!doc || !json) return JSON_ERROR_SYNTAX;
+    
+    doc->arena.used = 0;
+    doc->json = json;
+    doc->tape_length = 1; // root word, filled in at the end
+    doc->state = TAPE_VALUE;
+    doc->depth = 0;
+    
+    StructuralScanner scanner;
+    StructuralIndex* index = doc->index;
+    scanner_init(&scanner, json);
+    index->count = 0;
+    
+    int error = 0;
+    for (;;) {
+        scanner_next_window(&scanner, index);
+        
+        size_t count = index->count;
+        size_t consumed = 0;
+        error = build_tape(doc, index->positions, count, scanner.done, &consumed);
+        if (error || scanner.done) break;
+        
+        // Keep the unconsumed positions for the next window
+        memmove(index->positions, index->positions + consumed, (count - consumed) * sizeof(uint32_t));
+        index->count = count - consumed;
+    }
+    
+    if (!error && doc->state != TAPE_DONE) error = JSON_ERROR_SYNTAX;
+    if (!error) {
+        doc->arena.used = doc->tape_length * sizeof(uint64_t);
+        if (!arena_reserve(&doc->arena, sizeof(uint64_t))) error = JSON_ERROR_MEMORY;
+    }
+    if (error) {
+        doc->tape_length = 0;
+        return error;
+    }
+    
+    uint64_t* tape = (uint64_t*)doc->arena.base;
+    size_t length = doc->tape_length;
+    tape[0] = JSON_TAPE_TAG('r') | (uint64_t)(length + 1);
+    tape[length] = JSON_TAPE_TAG('r');
+    doc->tape_length = length + 1;
+    doc->arena.used = doc->tape_length * sizeof(uint64_t);
+    doc->json_length = scanner.length;
+    
+    return (int)doc->tape_length;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void json_document_destroy(JsonDocument* doc) {
+    if (doc) {
+        free(doc->arena.base);
+        free(doc->index);
+        free(doc);
+    }
+}
+
+// Tape index of the value at a JSON pointer such as "/items/0/name" ("" is the
+// whole document), or -1 if there is no such value
+EMSCRIPTEN_KEEPALIVE
+int json_tape_query(JsonDocument* doc, const char* path) {
+    if (!doc || !path || doc->tape_length == 0) return -1;
+    
+    size_t index = tape_query(doc, path);
+    return index ? (int)index : -1;
+}
+
+// Type tag of the value at index ('{', '[', '"', 'l', 'd', 't', 'f' or 'n'), or 0
+EMSCRIPTEN_KEEPALIVE
+int json_tape_type(JsonDocument* doc, int index) {
+    if (!doc || index <= 0 || (size_t)index >= doc->tape_length) return 0;
+    return (int)(((uint64_t*)doc->arena.base)[index] >> 56);
+}
+
+// Numeric value at index (integers are converted), or NaN for other types
+EMSCRIPTEN_KEEPALIVE
+double json_tape_get_number(JsonDocument* doc, int index) {
+    int type = json_tape_type(doc, index);
+    if (type != 'l' && type != 'd') return NAN;
+    
+    const uint64_t* payload = (const uint64_t*)doc->arena.base + index + 1;
+    if (type == 'l') {
+        int64_t integer;
+        memcpy(&integer, payload, sizeof(integer));
+        return (double)integer;
+    }
+    double real;
+    memcpy(&real, payload, sizeof(real));
+    return real;
+}
+
+// Bytes of the string at index, not NUL-terminated (see json_tape_string_length),
+// or nullptr for other types
+EMSCRIPTEN_KEEPALIVE
+const char* json_tape_get_string(JsonDocument* doc, int index) {
+    if (json_tape_type(doc, index) != '"') return nullptr;
+    return tape_string(doc, index);
+}
+
+// Length in bytes of the string at index, or -1 for other types
+EMSCRIPTEN_KEEPALIVE
+int json_tape_string_length(JsonDocument* doc, int index) {
+    if (json_tape_type(doc, index) != '"') return -1;
+    return (int)((uint64_t*)doc->arena.base)[index + 1];
+}
+
+// Number of elements of the array or fields of the object at index, or -1
+EMSCRIPTEN_KEEPALIVE
+int json_tape_count(JsonDocument* doc, int index) {
+    int type = json_tape_type(doc, index);
+    if (type != '{' && type != '[') return -1;
+    
+    const uint64_t* tape = (const uint64_t*)doc->arena.base;
+    size_t elements = (size_t)((tape[index] & JSON_TAPE_PAYLOAD_MASK) >> 32);
+    if (elements < JSON_TAPE_COUNT_MAX) return (int)elements;
+    
+    // The count saturated; walk the container
+    elements = 0;
+    char close = type == '{' ? '}' : ']';
+    for (size_t i = index + 1; (tape[i] >> 56) != (uint64_t)close; elements++) {
+        i = tape_skip(tape, i);
+        if (type == '{') i = tape_skip(tape, i);
+    }
+    return (int)elements;
+}
+
+// Sum of the numeric field key over the objects of a top-level array; the number
+// of objects that have it is stored in *record_count
+static double tape_field_total(JsonDocument* doc, const char* key, int* record_count) {
+    const uint64_t* tape = (const uint64_t*)doc->arena.base;
+    double total = 0.0;
+    *record_count = 0;
+    if ((tape[1] >> 56) != '[') return total;
+    
+    for (size_t i = 2; (tape[i] >> 56) != ']'; i = tape_skip(tape, i)) {
+        if ((tape[i] >> 56) != '{') continue;
+        size_t value = tape_find_field(doc, i, key, key + strlen(key));
+        if (value) {
+            total += json_tape_get_number(doc, (int)value);
+            (*record_count)++;
+        }
+    }
+    return total;
+}
+
+// Run the JSON parsing test through the DOM: parse onto the tape, then read the
+// "value" field of every element of the top-level array.
+// Returns [record_count, total_size, avg_value, parse_time_ms], like parse_json_data.
+EMSCRIPTEN_KEEPALIVE
+double* run_json_tape_test(int target_size_mb) {
+    char* json_data = generate_test_json(target_size_mb);
+    if (!json_data) return nullptr;
+    
+    JsonDocument* doc = json_document_create();
+    double* results = (double*)malloc(4 * sizeof(double));
+    if (!doc || !results) {
+        json_document_destroy(doc);
+        free(results);
+        free(json_data);
+        return nullptr;
+    }
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    int tape_length = json_document_parse(doc, json_data);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    int record_count = 0;
+    double total_value = tape_length > 0 ? tape_field_total(doc, "value", &record_count) : 0.0;
+    
+    results[0] = (double)record_count;
+    results[1] = (double)doc->json_length;
+    results[2] = (record_count > 0) ? total_value / record_count : 0.0;
+    results[3] = duration.count() / 1000.0;
+    
+    json_document_destroy(doc);
+    free(json_data);
+    
+    return results;
+}
+
+// Create an empty projection
+EMSCRIPTEN_KEEPALIVE
+JsonProjection* json_projection_create() {
+    JsonProjection* projection = (JsonProjection*)calloc(1, sizeof(JsonProjection));
+    if (!projection) return nullptr;
+    
+    projection->node_count = 1;
+    projection->nodes[0].first_child = -1;
+    projection->nodes[0].next_sibling = -1;
+    projection->nodes[0].field = -1;
+    
+    return projection;
+}
+
+// Register a key path: a JSON pointer relative to each record, such as "/value" or
+// "/meta/score" (object keys only). Returns the path's field index in the output
+// of json_project, or -1 if the path is invalid or a limit is reached.
+EMSCRIPTEN_KEEPALIVE
+int json_projection_add(JsonProjection* projection, const char* path) {
+    if (!projection || !path || path[0] != '/') return -1;
+    
+    int node = 0;
+    int levels = 0;
+    const char* p = path;
+    while (*p) {
+        const char* token = ++p;
+        while (*p && *p != '/') p++;
+        if (++levels >= JSON_PROJECTION_MAX_LEVELS) return -1;
+        if (projection->key_bytes + (p - token) > JSON_PROJECTION_KEY_BYTES) return -1;
+        
+        // Decode "~0" and "~1" into the end of the key storage
+        char* key = projection->keys + projection->key_bytes;
+        size_t length = 0;
+        for (const char* t = token; t < p; t++) {
+            if (*t == '~' && t + 1 < p && (t[1] == '0' || t[1] == '1')) {
+                key[length++] = t[1] == '0' ? '~' : '/';
+                t++;
+            } else {
+                key[length++] = *t;
+            }
+        }
+        
+        int child = projection_child(projection, node, key, length);
+        if (child < 0) {
+            if (projection->node_count == JSON_PROJECTION_MAX_NODES) return -1;
+            child = projection->node_count++;
+            ProjectionNode& added = projection->nodes[child];
+            added.prefix = key_prefix(key, length);
+            added.key = (uint32_t)projection->key_bytes;
+            added.length = (uint32_t)length;
+            added.first_child = -1;
+            added.next_sibling = projection->nodes[node].first_child;
+            added.field = -1;
+            projection->nodes[node].first_child = child;
+            projection->key_bytes += length;
+        }
+        node = child;
+    }
+    
+    ProjectionNode& leaf = projection->nodes[node];
+    if (leaf.field < 0) {
+        if (projection->field_count == JSON_PROJECTION_MAX_FIELDS) return -1;
+        leaf.field = projection->field_count++;
+    }
+    return leaf.field;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void json_projection_destroy(JsonProjection* projection) {
+    if (projection) {
+        free(projection);
+    }
+}
+
+// Extract the projected fields of up to max_records records from a NUL-terminated
+// document. Returns [record_count, field_count] followed by field_count cells of
+// JSON_PROJECTION_CELL doubles per record: type tag ('l', 'd', '"', 't', 'f', 'n',
+// '{' or '['; 0 when the record lacks the field), the number or the input offset of
+// a string (raw, escapes kept) or container, and its length in bytes.
+// Free with free_json_parser_data.
+EMSCRIPTEN_KEEPALIVE
+double* json_project(JsonProjection* projection, const char* json, int max_records) {
+    if (!projection || !json || max_records < 0) return nullptr;
+    
+    size_t row_size = (size_t)projection->field_count * JSON_PROJECTION_CELL;
+    ProjectionOutput output;
+    output.capacity = 1024;
+    output.record_count = 0;
+    output.max_records = max_records;
+    output.data = (double*)malloc((JSON_PROJECTION_HEADER + output.capacity * row_size) * sizeof(double));
+    StructuralIndex* index = (StructuralIndex*)malloc(sizeof(StructuralIndex));
+    if (!output.data || !index) {
+        free(output.data);
+        free(index);
+        return nullptr;
+    }
+    
+    ProjectionWalker walker;
+    memset(&walker, 0, sizeof(walker));
+    walker.pending = -1;
+    
+    StructuralScanner scanner;
+    scanner_init(&scanner, json);
+    index->count = 0;
+    
+    for (;;) {
+        scanner_next_window(&scanner, index);
+        
+        size_t count = index->count;
+        long consumed = project_records(projection, &walker, &output, json, index->positions, count, scanner.done);
+        if (consumed < 0) {
+            free(output.data);
+            free(index);
+            return nullptr;
+        }
+        if (scanner.done || output.record_count >= max_records) break;
+        
+        // Keep the unconsumed positions for the next window
+        memmove(index->positions, index->positions + consumed, (count - consumed) * sizeof(uint32_t));
+        index->count = count - consumed;
+    }
+    
+    output.data[0] = (double)output.record_count;
+    output.data[1] = (double)projection->field_count;
+    
+    free(index);
+    return output.data;
+}
+
+// Generate JSON records with extra_fields additional fields (numbers, strings and
+// nested objects) between "name" and "value"
+EMSCRIPTEN_KEEPALIVE
+char* generate_wide_test_json(int target_size_mb, int extra_fields) {
+    if (extra_fields < 0) return nullptr;
+    
+    int estimated_records = target_size_mb * 1024 * 1024 / (120 + 40 * extra_fields);
+    size_t buffer_size = target_size_mb * 1024 * 1024 + 1024;
+    char* result = (char*)malloc(buffer_size);
+    if (!result) {
+        return nullptr;
+    }
+    
+    generate_wide_json_data_internal(estimated_records, extra_fields, result, buffer_size);
+    return result;
+}
+
+// Read the "value" field of every record of a generated document, once through a
+// projection and once through the full tape DOM.
+// Returns [record_count, total_size, avg_value, projection_time_ms, tape_time_ms].
+EMSCRIPTEN_KEEPALIVE
+double* run_json_projection_test(int target_size_mb, int extra_fields) {
+    char* json_data = extra_fields > 0 ? generate_wide_test_json(target_size_mb, extra_fields)
+                                       : generate_test_json(target_size_mb);
+    if (!json_data) return nullptr;
+    
+    JsonProjection* projection = json_projection_create();
+    JsonDocument* doc = json_document_create();
+    double* results = (double*)malloc(5 * sizeof(double));
+    if (!projection || !doc || !results) {
+        json_projection_destroy(projection);
+        json_document_destroy(doc);
+        free(results);
+        free(json_data);
+        return nullptr;
+    }
+    int field = json_projection_add(projection, "/value");
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    double* projected = json_project(projection, json_data, 1 << 30);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double projection_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count() / 1000.0;
+    
+    int record_count = 0;
+    double total_value = 0.0;
+    if (projected) {
+        int records = (int)projected[0];
+        int fields = (int)projected[1];
+        for (int i = 0; i < records; i++) {
+            const double* cell = projected + JSON_PROJECTION_HEADER + (i * fields + field) * JSON_PROJECTION_CELL;
+            if (cell[0] == 'l' || cell[0] == 'd') {
+                total_value += cell[1];
+                record_count++;
+            }
+        }
+        free(projected);
+    }
+    
+    start_time = std::chrono::high_resolution_clock::now();
+    int tape_records = 0;
+    if (json_document_parse(doc, json_data) > 0) {
+        tape_field_total(doc, "value", &tape_records);
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    double tape_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count() / 1000.0;
+    
+    results[0] = (double)record_count;
+    results[1] = (double)strlen(json_data);
+    results[2] = (record_count > 0) ? total_value / record_count : 0.0;
+    results[3] = projection_time;
+    results[4] = tape_time;
+    
+    json_projection_destroy(projection);
+    json_document_destroy(doc);
+    free(json_data);
+    
+    return results;
+}
+
 // Debug function to test parsing with simple JSON
 EMSCRIPTEN_KEEPALIVE
 double* debug_parse_simple() {
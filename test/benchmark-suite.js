@@ -4,13 +4,14 @@ const fs = require('fs');
 const path = require('path');
 const readline = require('readline');
 const { TestRunnerWithDatabase } = require('./runner-with-database');
+const { loadWasmModule } = require('../utils/wasm-loader');
 
-// Import all WebAssembly modules
-const MatrixMultiplyWasmModule = require('../build/node/matrix-multiply.js');
-const FftWasmModule = require('../build/node/fft.js');
-const NumericIntegrationWasmModule = require('../build/node/numeric-integration.js');
+// Import all WebAssembly modules (math kernels use the SIMD build when supported)
+const MatrixMultiplyWasmModule = loadWasmModule('matrix-multiply');
+const FftWasmModule = loadWasmModule('fft');
+const NumericIntegrationWasmModule = loadWasmModule('numeric-integration');
 const GradientDescentWasmModule = require('../build/node/gradient-descent.js');
-const JsonParserWasmModule = require('../build/node/json-parser.js');
+const JsonParserWasmModule = loadWasmModule('json-parser');
 const CsvParserWasmModule = require('../build/node/csv-parser.js');
 
 // Import all JavaScript implementations
@@ -21,6 +22,566 @@ const GradientDescentImplementation = require('../js/math/gradient-descent.js');
 const JsonParserImplementation = require('../js/string/json-parser.js');
 const CsvParserImplementation = require('../js/string/csv-parser.js');
 
+// Helpers for the correctness checks: copy doubles into and out of a module's heap
+function writeDoubles(wasmInstance, values) {
+    const ptr = wasmInstance._malloc(values.length * 8);
+    for (let i = 0; i < values.length; i++) {
+        wasmInstance.setValue(ptr + i * 8, values[i], 'double');
+    }
+    return ptr;
+}
+
+function readDoubles(wasmInstance, ptr, count) {
+    const values = new Array(count);
+    for (let i = 0; i < count; i++) {
+        values[i] = wasmInstance.getValue(ptr + i * 8, 'double');
+    }
+    return values;
+}
+
+// Largest |a[i] - b[i]| relative to the largest |b[i]|; Infinity if either has a NaN
+function maxRelativeDiff(a, b) {
+    let diff = 0;
+    let scale = 1e-300;
+    for (let i = 0; i < b.length; i++) {
+        const d = Math.abs(a[i] - b[i]);
+        if (Number.isNaN(d)) return Infinity;
+        diff = Math.max(diff, d);
+        scale = Math.max(scale, Math.abs(b[i]));
+    }
+    return diff / scale;
+}
+
+// Instantiate the -mt build of a module, or return null when it has not been built
+async function instantiateThreadedModule(name) {
+    if (!fs.existsSync(path.join(__dirname, '..', 'build', 'node', `${name}-mt.js`))) return null;
+    
+    const module = loadWasmModule(`${name}-mt`);
+    const instance = await (module.default ? module.default() : module());
+    if (instance.ready) {
+        await instance.ready;
+    }
+    return instance;
+}
+
+// multiply_matrices_parallel (in the -mt build too, when built) must match
+// multiply_matrices, also after gemm_autotune has changed the blocking
+async function checkParallelMatrixMultiply(wasmInstance) {
+    const n = 203; // not a multiple of any block size
+    const instances = [['single-threaded build', wasmInstance]];
+    const threaded = await instantiateThreadedModule('matrix-multiply');
+    if (threaded) instances.push(['-mt build', threaded]);
+    
+    const discrepancies = [];
+    for (const [label, instance] of instances) {
+        const createRandomMatrix = instance.cwrap('create_random_matrix', 'number', ['number']);
+        const multiplyMatrices = instance.cwrap('multiply_matrices', 'number', ['number', 'number', 'number']);
+        const multiplyMatricesParallel = instance.cwrap('multiply_matrices_parallel', 'number', ['number', 'number', 'number', 'number']);
+        const gemmAutotune = instance.cwrap('gemm_autotune', 'number', ['number']);
+        const freeMatrix = instance.cwrap('free_matrix', null, ['number']);
+        
+        const A = createRandomMatrix(n);
+        const B = createRandomMatrix(n);
+        const reference = multiplyMatrices(A, B, n);
+        const parallel = multiplyMatricesParallel(A, B, n, 0);
+        const kc = gemmAutotune(n);
+        const tuned = multiplyMatrices(A, B, n);
+        if (!A || !B || !reference || !parallel || !tuned || kc <= 0) {
+            discrepancies.push(`${label}: a call failed`);
+        } else {
+            const a = readDoubles(instance, A, n * n);
+            const b = readDoubles(instance, B, n * n);
+            const c = readDoubles(instance, reference, n * n);
+            
+            // First and last rows against direct dot products
+            const rows = [0, n - 1];
+            const direct = [];
+            const blocked = [];
+            for (const i of rows) {
+                for (let j = 0; j < n; j++) {
+                    let sum = 0;
+                    for (let k = 0; k < n; k++) sum += a[i * n + k] * b[k * n + j];
+                    direct.push(sum);
+                    blocked.push(c[i * n + j]);
+                }
+            }
+            
+            const directDiff = maxRelativeDiff(blocked, direct);
+            const parallelDiff = maxRelativeDiff(readDoubles(instance, parallel, n * n), c);
+            const tunedDiff = maxRelativeDiff(readDoubles(instance, tuned, n * n), c);
+            if (directDiff > 1e-12) discrepancies.push(`${label}: multiply_matrices vs direct, diff=${directDiff.toExponential(2)}`);
+            if (parallelDiff > 1e-12) discrepancies.push(`${label}: parallel vs multiply_matrices, diff=${parallelDiff.toExponential(2)}`);
+            if (tunedDiff > 1e-12) discrepancies.push(`${label}: autotuned (kc=${kc}) vs default blocking, diff=${tunedDiff.toExponential(2)}`);
+        }
+        [A, B, reference, parallel, tuned].forEach(ptr => freeMatrix(ptr));
+    }
+    
+    return {
+        name: `multiply_matrices_parallel and gemm_autotune (${instances.map(([label]) => label).join(', ')})`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.join('; ')
+    };
+}
+
+// Frames pulled from the STFT pipeline, with samples pushed in uneven blocks, must
+// match compute_fft of each Hann-windowed frame
+function checkStftFrames(wasmInstance) {
+    const stftCreate = wasmInstance.cwrap('stft_create', 'number', ['number', 'number', 'number']);
+    const stftFrameSize = wasmInstance.cwrap('stft_frame_size', 'number', ['number']);
+    const stftPush = wasmInstance.cwrap('stft_push', 'number', ['number', 'number', 'number']);
+    const stftPull = wasmInstance.cwrap('stft_pull', 'number', ['number', 'number', 'number']);
+    const stftDestroy = wasmInstance.cwrap('stft_destroy', null, ['number']);
+    const computeFft = wasmInstance.cwrap('compute_fft', 'number', ['number', 'number']);
+    const freeFftData = wasmInstance.cwrap('free_fft_data', null, ['number']);
+    
+    const windowSize = 256;
+    const hop = 96;
+    const length = 4000;
+    const maxPull = 4;
+    const signal = [];
+    for (let i = 0; i < length; i++) {
+        signal.push(Math.sin(2 * Math.PI * 0.037 * i) + 0.5 * Math.cos(2 * Math.PI * 0.21 * i) + ((i * 7919) % 13 - 6) / 60);
+    }
+    
+    const state = stftCreate(windowSize, hop, 1); // Hann window
+    if (!state) return { name: 'STFT frames vs framed FFT', success: false, detail: 'stft_create failed' };
+    const frameSize = stftFrameSize(state);
+    const samplesPtr = writeDoubles(wasmInstance, signal);
+    const framesPtr = wasmInstance._malloc(maxPull * frameSize * 8);
+    
+    // Push in varying block sizes, pulling a few frames after each push
+    const frames = [];
+    const pullFrames = () => {
+        const pulled = stftPull(state, framesPtr, maxPull);
+        for (let f = 0; f < pulled; f++) {
+            frames.push(readDoubles(wasmInstance, framesPtr + f * frameSize * 8, frameSize));
+        }
+        return pulled;
+    };
+    let pushed = 0;
+    let block = 1;
+    while (pushed < length) {
+        const accepted = stftPush(state, samplesPtr + pushed * 8, Math.min(block, length - pushed));
+        pushed += accepted;
+        block = (block * 7 + 13) % 701 + 1;
+        if (pullFrames() === 0 && accepted === 0) break;
+    }
+    while (pullFrames() > 0) {}
+    
+    stftDestroy(state);
+    wasmInstance._free(samplesPtr);
+    wasmInstance._free(framesPtr);
+    
+    const expectedFrames = Math.floor((length - windowSize) / hop) + 1;
+    const discrepancies = [];
+    if (frames.length !== expectedFrames) {
+        discrepancies.push(`frame count: ${frames.length}, expected ${expectedFrames}`);
+    }
+    
+    let worstDiff = 0;
+    for (let f = 0; f < Math.min(frames.length, expectedFrames); f++) {
+        const windowed = new Array(2 * windowSize).fill(0);
+        for (let i = 0; i < windowSize; i++) {
+            windowed[2 * i] = signal[f * hop + i] * (0.5 - 0.5 * Math.cos(2 * Math.PI * i / windowSize));
+        }
+        const inputPtr = writeDoubles(wasmInstance, windowed);
+        const spectrumPtr = computeFft(inputPtr, windowSize);
+        worstDiff = Math.max(worstDiff, maxRelativeDiff(frames[f], readDoubles(wasmInstance, spectrumPtr, frameSize)));
+        freeFftData(spectrumPtr);
+        wasmInstance._free(inputPtr);
+    }
+    if (worstDiff > 1e-10) discrepancies.push(`frames differ from the framed FFT, diff=${worstDiff.toExponential(2)}`);
+    
+    return {
+        name: `STFT frames vs framed FFT (${expectedFrames} frames of ${windowSize}, hop ${hop})`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.join('; ')
+    };
+}
+
+// fft_convolve must match a direct O(na * nb) convolution, for either argument order
+function checkConvolution(wasmInstance) {
+    const fftConvolve = wasmInstance.cwrap('fft_convolve', 'number', ['number', 'number', 'number', 'number', 'number']);
+    
+    const cases = [[1000, 37], [37, 1000], [5, 5], [3000, 500]];
+    const discrepancies = [];
+    for (const [na, nb] of cases) {
+        const a = [];
+        const b = [];
+        for (let i = 0; i < na; i++) a.push(Math.sin(0.7 * i * i + 1));
+        for (let i = 0; i < nb; i++) b.push(Math.cos(0.3 * i * i + 2));
+        
+        const direct = new Array(na + nb - 1).fill(0);
+        for (let i = 0; i < na; i++) {
+            for (let j = 0; j < nb; j++) direct[i + j] += a[i] * b[j];
+        }
+        
+        const aPtr = writeDoubles(wasmInstance, a);
+        const bPtr = writeDoubles(wasmInstance, b);
+        const outPtr = wasmInstance._malloc((na + nb - 1) * 8);
+        if (fftConvolve(aPtr, na, bPtr, nb, outPtr) !== 0) {
+            discrepancies.push(`${na} * ${nb}: fft_convolve failed`);
+        } else {
+            const diff = maxRelativeDiff(readDoubles(wasmInstance, outPtr, na + nb - 1), direct);
+            if (diff > 1e-10) discrepancies.push(`${na} * ${nb}: diff=${diff.toExponential(2)}`);
+        }
+        [aPtr, bPtr, outPtr].forEach(ptr => wasmInstance._free(ptr));
+    }
+    
+    return {
+        name: `fft_convolve vs direct convolution (${cases.map(([na, nb]) => `${na}*${nb}`).join(', ')})`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.join('; ')
+    };
+}
+
+// compute_fft2d must match a direct 2D DFT at a few bins and round-trip through its
+// inverse, conj(FFT2(conj(X))) / (rows * cols)
+function checkFft2dRoundTrip(wasmInstance) {
+    const computeFft2d = wasmInstance.cwrap('compute_fft2d', 'number', ['number', 'number', 'number']);
+    
+    const shapes = [[12, 20], [16, 8], [7, 1]];
+    const discrepancies = [];
+    for (const [rows, cols] of shapes) {
+        const input = [];
+        for (let i = 0; i < rows * cols; i++) {
+            input.push(Math.sin(1.3 * i + 0.5), Math.cos(0.9 * i * i));
+        }
+        
+        const ptr = writeDoubles(wasmInstance, input);
+        const conjugate = () => {
+            for (let i = 0; i < rows * cols; i++) {
+                const im = ptr + (2 * i + 1) * 8;
+                wasmInstance.setValue(im, -wasmInstance.getValue(im, 'double'), 'double');
+            }
+        };
+        
+        if (computeFft2d(ptr, rows, cols) !== 0) {
+            discrepancies.push(`${rows}x${cols}: compute_fft2d failed`);
+            wasmInstance._free(ptr);
+            continue;
+        }
+        const spectrum = readDoubles(wasmInstance, ptr, 2 * rows * cols);
+        
+        // Direct DFT at a few bins
+        const bins = [[0, 0], [1 % rows, 3 % cols], [rows - 1, cols - 1]];
+        const direct = [];
+        const computed = [];
+        for (const [u, v] of bins) {
+            let re = 0;
+            let im = 0;
+            for (let r = 0; r < rows; r++) {
+                for (let c = 0; c < cols; c++) {
+                    const angle = -2 * Math.PI * (u * r / rows + v * c / cols);
+                    const xr = input[2 * (r * cols + c)];
+                    const xi = input[2 * (r * cols + c) + 1];
+                    re += xr * Math.cos(angle) - xi * Math.sin(angle);
+                    im += xr * Math.sin(angle) + xi * Math.cos(angle);
+                }
+            }
+            direct.push(re, im);
+            computed.push(spectrum[2 * (u * cols + v)], spectrum[2 * (u * cols + v) + 1]);
+        }
+        const dftDiff = maxRelativeDiff(computed, direct);
+        if (dftDiff > 1e-10) discrepancies.push(`${rows}x${cols}: bins differ from the direct DFT, diff=${dftDiff.toExponential(2)}`);
+        
+        // Inverse transform and compare with the input
+        conjugate();
+        computeFft2d(ptr, rows, cols);
+        conjugate();
+        const roundTrip = readDoubles(wasmInstance, ptr, 2 * rows * cols).map(value => value / (rows * cols));
+        const roundTripDiff = maxRelativeDiff(roundTrip, input);
+        if (roundTripDiff > 1e-12) discrepancies.push(`${rows}x${cols}: round trip diff=${roundTripDiff.toExponential(2)}`);
+        
+        wasmInstance._free(ptr);
+    }
+    
+    return {
+        name: `compute_fft2d round trip (${shapes.map(([rows, cols]) => `${rows}x${cols}`).join(', ')})`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.join('; ')
+    };
+}
+
+// integrate_adaptive must reproduce closed-form integrals, with the sign flipped
+// when the bounds are reversed
+function checkAdaptiveIntegration(wasmInstance) {
+    const createExpSin = wasmInstance.cwrap('integrand_create_exp_sin', 'number', ['number', 'number', 'number', 'number']);
+    const destroyIntegrand = wasmInstance.cwrap('integrand_destroy', null, ['number']);
+    const integrateAdaptive = wasmInstance.cwrap('integrate_adaptive', 'number', ['number', 'number', 'number', 'number', 'number', 'number']);
+    const freeIntegrationData = wasmInstance.cwrap('free_integration_data', null, ['number']);
+    
+    // Antiderivative of amplitude * exp(rate*x) * sin(frequency*x + phase)
+    const expSinPrimitive = (amplitude, rate, frequency, phase) => (x) =>
+        amplitude * Math.exp(rate * x) *
+        (rate * Math.sin(frequency * x + phase) - frequency * Math.cos(frequency * x + phase)) /
+        (rate * rate + frequency * frequency);
+    
+    const cases = [
+        { label: 'sin(20x)', params: [1, 0, 20, 0], a: 0, b: 5 },
+        { label: 'sin(20x)', params: [1, 0, 20, 0], a: 5, b: 0 },
+        { label: '2e^(-x/2)sin(3x+0.4)', params: [2, -0.5, 3, 0.4], a: -1, b: 4 },
+        { label: '2e^(-x/2)sin(3x+0.4)', params: [2, -0.5, 3, 0.4], a: 4, b: -1 },
+        { label: '(x+1)^2', params: null, a: 0, b: 3 },
+        { label: '(x+1)^2', params: null, a: 3, b: 0 }
+    ];
+    
+    const discrepancies = [];
+    for (const { label, params, a, b } of cases) {
+        const primitive = params ? expSinPrimitive(...params) : (x) => Math.pow(x + 1, 3) / 3;
+        const exact = primitive(b) - primitive(a);
+        
+        const integrand = params ? createExpSin(...params) : 0;
+        const resultPtr = integrateAdaptive(integrand, a, b, 1e-12, 1e-10, 200000);
+        if (integrand) destroyIntegrand(integrand);
+        if (!resultPtr) {
+            discrepancies.push(`${label} on [${a}, ${b}]: integrate_adaptive failed`);
+            continue;
+        }
+        
+        const [value, errorEstimate] = readDoubles(wasmInstance, resultPtr, 2);
+        freeIntegrationData(resultPtr);
+        const error = Math.abs(value - exact);
+        if (!(error <= Math.max(1e-10, 1e-8 * Math.abs(exact))) || !(errorEstimate >= 0)) {
+            discrepancies.push(`${label} on [${a}, ${b}]: value=${value}, exact=${exact}, error estimate=${errorEstimate}`);
+        }
+    }
+    
+    return {
+        name: `integrate_adaptive vs closed forms (${cases.length} intervals, forward and reversed)`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.slice(0, 3).join('; ')
+    };
+}
+
+// Error function by its Taylor series; accurate to ~1e-15 for |x| <= 3
+function erf(x) {
+    let term = x;
+    let sum = x;
+    for (let n = 1; n < 100 && Math.abs(term) > 1e-17 * Math.abs(sum); n++) {
+        term *= -x * x / n;
+        sum += term / (2 * n + 1);
+    }
+    return 2 / Math.sqrt(Math.PI) * sum;
+}
+
+// integrate_monte_carlo must agree with the closed form of a Genz gaussian over the
+// unit cube within its standard error, and the quasi-Monte Carlo samplers must beat
+// the PRNG standard error at the same evaluation budget
+function checkMonteCarloIntegration(wasmInstance) {
+    const createGenzGaussian = wasmInstance.cwrap('integrand_create_genz_gaussian', 'number', ['number', 'number', 'number']);
+    const destroyIntegrand = wasmInstance.cwrap('integrand_destroy', null, ['number']);
+    const integrateMonteCarlo = wasmInstance.cwrap('integrate_monte_carlo', 'number',
+        ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    const freeIntegrationData = wasmInstance.cwrap('free_integration_data', null, ['number']);
+    
+    // exp(-sum c^2 (x - w)^2) factorises into one erf difference per dimension
+    const c = [1.5, 2.0, 0.8, 1.2];
+    const w = [0.3, 0.6, 0.5, 0.45];
+    let exact = 1;
+    for (let k = 0; k < c.length; k++) {
+        exact *= Math.sqrt(Math.PI) / (2 * c[k]) * (erf(c[k] * (1 - w[k])) + erf(c[k] * w[k]));
+    }
+    
+    const cPtr = writeDoubles(wasmInstance, c);
+    const wPtr = writeDoubles(wasmInstance, w);
+    const integrand = createGenzGaussian(c.length, cPtr, wPtr);
+    wasmInstance._free(cPtr);
+    wasmInstance._free(wPtr);
+    
+    // Tolerances no sampler can meet, so every sampler spends the whole budget
+    const replicates = 8;
+    const blockSize = 1024;
+    const maxEvals = 1 << 17;
+    const samplers = ['PRNG', 'Halton', 'Sobol'];
+    const discrepancies = [];
+    const results = [];
+    for (let sampler = 0; sampler < samplers.length; sampler++) {
+        const resultPtr = integrateMonteCarlo(integrand, 0, 0, sampler, replicates, blockSize, maxEvals, 1e-15, 1e-15, 42, 0);
+        if (!resultPtr) {
+            discrepancies.push(`${samplers[sampler]}: integrate_monte_carlo failed`);
+            continue;
+        }
+        const [estimate, standardError, evaluations] = readDoubles(wasmInstance, resultPtr, 3);
+        freeIntegrationData(resultPtr);
+        results[sampler] = { standardError, evaluations };
+        
+        if (!(Math.abs(estimate - exact) <= 5 * standardError + 1e-12)) {
+            discrepancies.push(`${samplers[sampler]}: estimate=${estimate}, exact=${exact}, stderr=${standardError.toExponential(2)}`);
+        }
+    }
+    
+    if (results.length === samplers.length && results.every(Boolean)) {
+        for (const sampler of [1, 2]) {
+            if (results[sampler].evaluations !== results[0].evaluations) {
+                discrepancies.push(`${samplers[sampler]} used ${results[sampler].evaluations} evaluations, PRNG ${results[0].evaluations}`);
+            } else if (!(results[sampler].standardError < results[0].standardError)) {
+                discrepancies.push(`${samplers[sampler]} stderr ${results[sampler].standardError.toExponential(2)} not below PRNG ${results[0].standardError.toExponential(2)}`);
+            }
+        }
+    }
+    
+    // A budget smaller than the first round is rejected
+    if (integrateMonteCarlo(integrand, 0, 0, 0, replicates, blockSize, replicates * blockSize - 1, 1e-15, 1e-15, 42, 0) !== 0) {
+        discrepancies.push('budget below replicates * block_size was accepted');
+    }
+    destroyIntegrand(integrand);
+    
+    return {
+        name: `integrate_monte_carlo vs Genz gaussian closed form (${c.length}D, ${maxEvals} evaluations)`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.join('; ')
+    };
+}
+
+// Every optimizer of run_optimizer_test must cut the Rosenbrock cost to under 5% of
+// its cost after the first iteration, and OPTIMIZER_SGD must reproduce
+// run_gradient_descent_test exactly
+function checkOptimizers(wasmInstance) {
+    const runOptimizerTest = wasmInstance.cwrap('run_optimizer_test', 'number', ['number', 'number', 'number']);
+    const runGradientDescentTest = wasmInstance.cwrap('run_gradient_descent_test', 'number', ['number', 'number']);
+    const freeGradientDescentData = wasmInstance.cwrap('free_gradient_descent_data', null, ['number']);
+    
+    const finalCost = (resultPtr) => {
+        if (!resultPtr) return NaN;
+        const cost = wasmInstance.getValue(resultPtr, 'double');
+        freeGradientDescentData(resultPtr);
+        return cost;
+    };
+    
+    const iterations = 1000;
+    const nParams = 10;
+    const optimizers = ['SGD', 'Momentum', 'Nesterov', 'Adam', 'RMSProp'];
+    const costs = [];
+    const discrepancies = [];
+    for (let optimizer = 0; optimizer < optimizers.length; optimizer++) {
+        const firstCost = finalCost(runOptimizerTest(1, nParams, optimizer));
+        const cost = finalCost(runOptimizerTest(iterations, nParams, optimizer));
+        costs.push(`${optimizers[optimizer]}=${cost.toPrecision(3)}`);
+        if (!Number.isFinite(cost) || !(cost >= 0 && cost < 0.05 * firstCost)) {
+            discrepancies.push(`${optimizers[optimizer]}: cost ${cost} after ${iterations} iterations, ${firstCost} after 1`);
+        }
+    }
+    
+    const sgdCost = finalCost(runOptimizerTest(iterations, nParams, 0));
+    const referenceCost = finalCost(runGradientDescentTest(iterations, nParams));
+    if (sgdCost !== referenceCost) {
+        discrepancies.push(`SGD cost ${sgdCost} differs from run_gradient_descent_test ${referenceCost}`);
+    }
+    
+    return {
+        name: `run_optimizer_test final costs (${iterations} iterations, ${nParams} params: ${costs.join(', ')})`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.join('; ')
+    };
+}
+
+// L-BFGS must converge on Rosenbrock: run_lbfgs_test to the global minimum, and
+// lbfgs_minimize from the classic starting points to a gradient norm below its tolerance
+function checkLbfgs(wasmInstance) {
+    const runLbfgsTest = wasmInstance.cwrap('run_lbfgs_test', 'number', ['number', 'number']);
+    const lbfgsMinimize = wasmInstance.cwrap('lbfgs_minimize', 'number', ['number', 'number', 'number', 'number', 'number', 'number']);
+    const freeGradientDescentData = wasmInstance.cwrap('free_gradient_descent_data', null, ['number']);
+    
+    const discrepancies = [];
+    
+    const testPtr = runLbfgsTest(1000, 10);
+    if (!testPtr) {
+        discrepancies.push('run_lbfgs_test failed');
+    } else {
+        const [cost, , avgParam, firstParam] = readDoubles(wasmInstance, testPtr, 4);
+        freeGradientDescentData(testPtr);
+        if (!(cost < 1e-12) || !(Math.abs(avgParam - 1) < 1e-6) || !(Math.abs(firstParam - 1) < 1e-6)) {
+            discrepancies.push(`run_lbfgs_test: cost=${cost}, avg=${avgParam}, first=${firstParam}`);
+        }
+    }
+    
+    // (-1.2, 1) repeated, the standard Rosenbrock start, in 2 and 20 dimensions
+    const gradTol = 1e-8;
+    for (const n of [2, 20]) {
+        const start = [];
+        for (let i = 0; i < n; i++) start.push(i % 2 === 0 ? -1.2 : 1);
+        const xPtr = writeDoubles(wasmInstance, start);
+        const statsPtr = lbfgsMinimize(0, xPtr, n, 10, 2000, gradTol);
+        const x = readDoubles(wasmInstance, xPtr, n);
+        wasmInstance._free(xPtr);
+        if (!statsPtr) {
+            discrepancies.push(`lbfgs_minimize (n=${n}) failed`);
+            continue;
+        }
+        
+        const [value, gradNorm, iterations, , status] = readDoubles(wasmInstance, statsPtr, 5);
+        freeGradientDescentData(statsPtr);
+        const distance = Math.max(...x.map(xi => Math.abs(xi - 1)));
+        if (status !== 0 || !(gradNorm <= gradTol) || !(value < 1e-14) || !(distance < 1e-6)) {
+            discrepancies.push(`lbfgs_minimize (n=${n}): status=${status}, grad=${gradNorm}, f=${value}, ` +
+                `max|x-1|=${distance}, ${iterations} iterations`);
+        }
+    }
+    
+    return {
+        name: 'L-BFGS convergence on Rosenbrock (run_lbfgs_test 10D, lbfgs_minimize 2D and 20D)',
+        success: discrepancies.length === 0,
+        detail: discrepancies.join('; ')
+    };
+}
+
+// gradient_descent_multistart must return bit-identical results for every thread
+// count, on the plain build and on the -mt build when it exists
+async function checkMultistartDeterminism(wasmInstance) {
+    const nParams = 10;
+    const nStarts = 13;
+    const iterations = 300;
+    const resultLength = 2 + 3 * nStarts + nParams;
+    
+    const instances = [['single-threaded build', wasmInstance]];
+    const threaded = await instantiateThreadedModule('gradient-descent');
+    if (threaded) instances.push(['-mt build', threaded]);
+    
+    let reference = null;
+    const discrepancies = [];
+    const runs = [];
+    for (const [label, instance] of instances) {
+        const multistart = instance.cwrap('gradient_descent_multistart', 'number', ['number', 'number', 'number', 'number']);
+        const evaluateRosenbrock = instance.cwrap('evaluate_rosenbrock', 'number', ['number', 'number']);
+        const freeGradientDescentData = instance.cwrap('free_gradient_descent_data', null, ['number']);
+        
+        for (const threads of [1, 2, 3, 4, 0]) {
+            runs.push(`${label}/${threads}`);
+            const resultPtr = multistart(nParams, nStarts, iterations, threads);
+            if (!resultPtr) {
+                discrepancies.push(`${label}, ${threads} threads: gradient_descent_multistart failed`);
+                continue;
+            }
+            const result = readDoubles(instance, resultPtr, resultLength);
+            const bestCost = evaluateRosenbrock(resultPtr + (2 + 3 * nStarts) * 8, nParams);
+            freeGradientDescentData(resultPtr);
+            
+            // The reported best must be the lowest per-start cost, and its parameters must reproduce it
+            const costs = [];
+            for (let s = 0; s < nStarts; s++) costs.push(result[2 + 3 * s]);
+            if (result[0] !== Math.min(...costs) || result[0] !== costs[result[1]] || bestCost !== result[0]) {
+                discrepancies.push(`${label}, ${threads} threads: best cost ${result[0]} (start ${result[1]}) inconsistent`);
+            }
+            
+            if (!reference) {
+                reference = result;
+            } else {
+                const index = result.findIndex((value, i) => !Object.is(value, reference[i]));
+                if (index >= 0) {
+                    discrepancies.push(`${label}, ${threads} threads: entry ${index} is ${result[index]}, expected ${reference[index]}`);
+                }
+            }
+        }
+    }
+    
+    return {
+        name: `gradient_descent_multistart determinism (${nStarts} starts, ${runs.length} thread settings)`,
+        success: discrepancies.length === 0,
+        detail: discrepancies.slice(0, 3).join('; ')
+    };
+}
+
 // Test configurations
 const TEST_CONFIGS = {
     'matrix': {
@@ -29,6 +590,8 @@ const TEST_CONFIGS = {
         iterations: 1, // Only 1 iteration for large matrices
         wasmModule: MatrixMultiplyWasmModule,
         jsImplementation: MatrixMultiplyImplementation,
+        // Exports the size benchmark does not cover, checked once per run
+        checks: [checkParallelMatrixMultiply],
         sizes: {
             small: 50,   // 50x50 matrices
             medium: 500, // 500x500 matrices
@@ -72,6 +635,7 @@ const TEST_CONFIGS = {
         iterations: 5, // Moderate iterations for FFT
         wasmModule: FftWasmModule,
         jsImplementation: FftImplementation,
+        checks: [checkStftFrames, checkConvolution, checkFft2dRoundTrip],
         sizes: {
             small: 256,   // 256 points
             medium: 1024, // 1024 points
@@ -141,6 +705,7 @@ const TEST_CONFIGS = {
         iterations: 3, // Moderate iterations for integration
         wasmModule: NumericIntegrationWasmModule,
         jsImplementation: NumericIntegrationImplementation,
+        checks: [checkAdaptiveIntegration, checkMonteCarloIntegration],
         sizes: {
             small: 1000,    // 1000 points
             medium: 10000,  // 10000 points
@@ -193,6 +758,7 @@ const TEST_CONFIGS = {
         iterations: 3, // Moderate iterations for gradient descent
         wasmModule: GradientDescentWasmModule,
         jsImplementation: GradientDescentImplementation,
+        checks: [checkOptimizers, checkLbfgs, checkMultistartDeterminism],
         sizes: {
             small: { iterations: 100, parameters: 10 },     // 100 iterations, 10 parameters
             medium: { iterations: 1000, parameters: 100 },  // 1000 iterations, 100 parameters
@@ -439,6 +1005,27 @@ function createResultsFile(algorithmKey, algorithmName) {
     return resultsFile;
 }
 
+// Run a module's correctness checks and report each one
+async function runWasmChecks(config, wasmInstance) {
+    if (!config.checks || config.checks.length === 0) return true;
+    
+    console.log(`Running ${config.name} correctness checks...`);
+    let passed = 0;
+    for (const check of config.checks) {
+        let result;
+        try {
+            result = await check(wasmInstance);
+        } catch (error) {
+            result = { name: check.name, success: false, detail: error.message };
+        }
+        console.log(`   ${result.success ? '✅' : '❌'} ${result.name}${result.detail ? ` - ${result.detail}` : ''}`);
+        if (result.success) passed++;
+    }
+    console.log(`   ${passed}/${config.checks.length} checks passed`);
+    
+    return passed === config.checks.length;
+}
+
 async function runSingleTest(algorithmKey) {
     const config = TEST_CONFIGS[algorithmKey];
     console.log(`\n🚀 Running ${config.name} benchmark...`);
@@ -455,6 +1042,8 @@ async function runSingleTest(algorithmKey) {
         
         console.log(`${config.name} WebAssembly module initialized successfully`);
         
+        await runWasmChecks(config, wasmInstance);
+        
         // Create wrapped modules
         const wasmModule = config.createWasmWrapper(wasmInstance);
         const jsModule = new config.jsImplementation();
@@ -759,6 +1348,8 @@ async function runSingleTestHeavy(algorithmKey) {
         
         console.log(`${config.name} WebAssembly module initialized successfully`);
         
+        await runWasmChecks(config, wasmInstance);
+        
         // Create wrapped modules
         const wasmModule = config.createWasmWrapper(wasmInstance);
         const jsModule = new config.jsImplementation();
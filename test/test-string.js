@@ -195,6 +195,174 @@ async function runJsonParserTest(runner) {
     }
 }
 
+/**
+ * Read the first `length` doubles of a result array and free it
+ * @param {Object} wasmInstance - The WebAssembly instance
+ * @param {number} resultPtr - Pointer returned by one of the run_json_*_test functions
+ * @param {number} length - Number of doubles to read
+ * @returns {number[]|null} The values, or null for a failed call
+ */
+function readJsonResult(wasmInstance, resultPtr, length) {
+    if (!resultPtr) return null;
+    const values = [];
+    for (let i = 0; i < length; i++) {
+        values.push(wasmInstance.getValue(resultPtr + i * 8, 'double'));
+    }
+    wasmInstance.cwrap('free_json_parser_data', null, ['number'])(resultPtr);
+    return values;
+}
+
+/**
+ * Compare [record_count, total_size, avg_value] with the run_json_parser_test result
+ * @returns {string|null} A description of the mismatch, or null when they agree
+ */
+function compareJsonStatistics(label, result, reference) {
+    if (!result) return `${label}: call failed`;
+    const [count, size, avgValue] = result;
+    const avgValueDiff = Math.abs(avgValue - reference[2]) / Math.max(Math.abs(reference[2]), 1e-300);
+    if (count !== reference[0] || size !== reference[1] || !(avgValueDiff <= 1e-12)) {
+        return `${label}: [${count}, ${size}, ${avgValue}] vs parser [${reference.slice(0, 3).join(', ')}]`;
+    }
+    return null;
+}
+
+/**
+ * Streaming parser check: feeding the generated document in chunks from 1 byte to
+ * 64 KB must give the statistics of run_json_parser_test
+ * @param {Object} wasmInstance - The WebAssembly instance
+ * @param {number} sizeMb - Document size
+ * @param {number[]} reference - run_json_parser_test(sizeMb) result
+ * @returns {string[]} Discrepancies
+ */
+function checkJsonStream(wasmInstance, sizeMb, reference) {
+    const generateTestJson = wasmInstance.cwrap('generate_test_json', 'number', ['number']);
+    const freeJsonString = wasmInstance.cwrap('free_json_string', null, ['number']);
+    const streamCreate = wasmInstance.cwrap('json_stream_create', 'number', []);
+    const streamFeed = wasmInstance.cwrap('json_stream_feed', 'number', ['number', 'number', 'number']);
+    const streamFinish = wasmInstance.cwrap('json_stream_finish', 'number', ['number']);
+    const streamStats = wasmInstance.cwrap('json_stream_stats', 'number', ['number']);
+    const streamDestroy = wasmInstance.cwrap('json_stream_destroy', null, ['number']);
+    const runJsonStreamTest = wasmInstance.cwrap('run_json_stream_test', 'number', ['number', 'number']);
+    
+    const discrepancies = [];
+    const jsonPtr = generateTestJson(sizeMb);
+    const length = reference[1];
+    
+    for (const chunkSize of [1, 3, 64, 1000, 4096, 65536]) {
+        const stream = streamCreate();
+        let completed = 0;
+        for (let offset = 0; offset < length && completed >= 0; offset += chunkSize) {
+            const records = streamFeed(stream, jsonPtr + offset, Math.min(chunkSize, length - offset));
+            completed = records < 0 ? -1 : completed + records;
+        }
+        if (completed >= 0) {
+            const records = streamFinish(stream);
+            completed = records < 0 ? -1 : completed + records;
+        }
+        
+        const stats = completed >= 0 ? readJsonResult(wasmInstance, streamStats(stream), 3) : null;
+        streamDestroy(stream);
+        
+        const mismatch = compareJsonStatistics(`${chunkSize} byte chunks`, stats, reference);
+        if (mismatch) {
+            discrepancies.push(mismatch);
+        } else if (completed !== stats[0]) {
+            discrepancies.push(`${chunkSize} byte chunks: feed/finish reported ${completed} records, stats ${stats[0]}`);
+        }
+    }
+    freeJsonString(jsonPtr);
+    
+    for (const chunkKb of [1, 64]) {
+        const mismatch = compareJsonStatistics(`run_json_stream_test(${sizeMb}, ${chunkKb})`,
+            readJsonResult(wasmInstance, runJsonStreamTest(sizeMb, chunkKb), 3), reference);
+        if (mismatch) discrepancies.push(mismatch);
+    }
+    
+    return discrepancies;
+}
+
+/**
+ * Tape DOM check: run_json_tape_test must give the statistics of run_json_parser_test
+ * @param {Object} wasmInstance - The WebAssembly instance
+ * @param {number} sizeMb - Document size
+ * @param {number[]} reference - run_json_parser_test(sizeMb) result
+ * @returns {string[]} Discrepancies
+ */
+function checkJsonTape(wasmInstance, sizeMb, reference) {
+    const runJsonTapeTest = wasmInstance.cwrap('run_json_tape_test', 'number', ['number']);
+    const mismatch = compareJsonStatistics(`run_json_tape_test(${sizeMb})`,
+        readJsonResult(wasmInstance, runJsonTapeTest(sizeMb), 3), reference);
+    return mismatch ? [mismatch] : [];
+}
+
+/**
+ * Projection check: run_json_projection_test must give the statistics of
+ * run_json_parser_test, and on documents with extra fields those of parse_json_data
+ * over the same generated document
+ * @param {Object} wasmInstance - The WebAssembly instance
+ * @param {number} sizeMb - Document size
+ * @param {number[]} reference - run_json_parser_test(sizeMb) result
+ * @returns {string[]} Discrepancies
+ */
+function checkJsonProjection(wasmInstance, sizeMb, reference) {
+    const runJsonProjectionTest = wasmInstance.cwrap('run_json_projection_test', 'number', ['number', 'number']);
+    const generateWideTestJson = wasmInstance.cwrap('generate_wide_test_json', 'number', ['number', 'number']);
+    const parseJsonData = wasmInstance.cwrap('parse_json_data', 'number', ['number']);
+    const freeJsonString = wasmInstance.cwrap('free_json_string', null, ['number']);
+    
+    const discrepancies = [];
+    for (const extraFields of [0, 1, 4, 16]) {
+        let expected = reference;
+        if (extraFields > 0) {
+            const jsonPtr = generateWideTestJson(sizeMb, extraFields);
+            expected = readJsonResult(wasmInstance, parseJsonData(jsonPtr), 3);
+            freeJsonString(jsonPtr);
+            if (!expected) {
+                discrepancies.push(`parse_json_data failed with ${extraFields} extra fields`);
+                continue;
+            }
+        }
+        
+        const mismatch = compareJsonStatistics(`run_json_projection_test(${sizeMb}, ${extraFields})`,
+            readJsonResult(wasmInstance, runJsonProjectionTest(sizeMb, extraFields), 3), expected);
+        if (mismatch) discrepancies.push(mismatch);
+    }
+    return discrepancies;
+}
+
+/**
+ * Check the alternative parsers against run_json_parser_test before benchmarking
+ * @param {Object} wasmInstance - The WebAssembly instance
+ */
+async function runJsonConsistencyChecks(wasmInstance) {
+    const sizeMb = 1;
+    const checks = [
+        ['Streaming parser', checkJsonStream],
+        ['Tape DOM', checkJsonTape],
+        ['Projection', checkJsonProjection]
+    ];
+    
+    const runJsonParserTest = wasmInstance.cwrap('run_json_parser_test', 'number', ['number']);
+    const reference = readJsonResult(wasmInstance, runJsonParserTest(sizeMb), 3);
+    if (!reference) {
+        throw new Error('JSON parser test failed');
+    }
+    
+    let failed = 0;
+    for (const [name, check] of checks) {
+        const discrepancies = check(wasmInstance, sizeMb, reference);
+        if (discrepancies.length === 0) {
+            console.log(`✅ ${name} matches run_json_parser_test (${sizeMb}MB)`);
+        } else {
+            console.log(`❌ ${name} differs from run_json_parser_test (${sizeMb}MB): ${discrepancies.slice(0, 3).join('; ')}`);
+            failed++;
+        }
+    }
+    if (failed > 0) {
+        throw new Error(`${failed} of ${checks.length} JSON consistency checks failed`);
+    }
+}
+
 /**
  * Main function to run all JSON Parser benchmark tests
  */
@@ -249,6 +417,9 @@ async function runAllTests() {
         console.log('ccall available:', typeof wasmInstance.ccall);
         console.log('getValue available:', typeof wasmInstance.getValue);
         
+        // Check the other parsers against run_json_parser_test
+        await runJsonConsistencyChecks(wasmInstance);
+        
         // Create wrapped WebAssembly module
         const wasmModule = createWasmModule(wasmInstance);
         
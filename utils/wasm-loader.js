@@ -0,0 +1,36 @@
+const fs = require('fs');
+const path = require('path');
+
+const NODE_BUILD_DIR = path.join(__dirname, '..', 'build', 'node');
+
+// Smallest module using a v128 instruction (i8x16.splat + i8x16.popcnt);
+// it only validates on runtimes with WebAssembly SIMD128 support
+const SIMD_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0,
+    65, 0, 253, 15, 253, 98, 11
+]);
+
+let simdSupported = null;
+
+function supportsSimd() {
+    if (simdSupported === null) {
+        try {
+            simdSupported = typeof WebAssembly === 'object' && WebAssembly.validate(SIMD_PROBE);
+        } catch (error) {
+            simdSupported = false;
+        }
+    }
+    return simdSupported;
+}
+
+// Load build/node/<name>.js, preferring the <name>-simd.js variant when the
+// runtime supports SIMD128 and the variant has been built.
+// Set WASM_SIMD=0 to force the scalar build.
+function loadWasmModule(name) {
+    const simdPath = path.join(NODE_BUILD_DIR, `${name}-simd.js`);
+    const useSimd = process.env.WASM_SIMD !== '0' && supportsSimd() && fs.existsSync(simdPath);
+
+    return require(useSimd ? simdPath : path.join(NODE_BUILD_DIR, `${name}.js`));
+}
+
+module.exports = { loadWasmModule, supportsSimd };